@@ -4,7 +4,11 @@
 #include "../include/scheduler.hpp"
 #include "../include/event.hpp"
 #include "../include/scope_timer.hpp"
+#include "../include/static_graph.hpp"
+#include "../include/reducer.hpp"
+#include "../include/reactor.hpp"
 #include <iostream>
+#include <string>
 #include <chrono>
 #include <atomic>
 #include <thread>
@@ -12,6 +16,7 @@
 #include <numeric>
 #include <algorithm>
 #include <random>
+#include <unistd.h>
 static std::mutex coutMutex;
 
 class BenchmarkSuite {
@@ -27,6 +32,15 @@ private:
     static inline std::atomic<size_t> globalSum = 0;
     static inline Scheduler scheduler;
     static inline bool schedulerStarted = false;
+    static inline int failedChecks = 0;
+
+    // A demo whose outcome is wrong reports it here; VerifyAll() returns
+    // the count so bin/main exits non-zero
+    static void Expect(bool ok, const std::string& what) {
+        if (ok) return;
+        std::cerr << "[Check failed] " << what << std::endl;
+        ++failedChecks;
+    }
 
 
 public:
@@ -65,6 +79,22 @@ public:
         }
     }
 
+    // Same work as BasicScheduler, submitted as a single bulk range
+    static void BulkScheduler(std::vector<long long>& results) {
+        globalSum.store(0);
+        InitScheduler();
+        {
+            ScopeTimer t("Bulk Scheduler Benchmark", &results);
+            BulkHandle bulk = scheduler.scheduleBulk(Scheduler::DETACHED_ID, 1, NUM_EVENTS + 1,
+                [](size_t i) {
+                    globalSum.fetch_add(array[(i * 75431) % DATA_SIZE],
+                                        std::memory_order_relaxed);
+                });
+            scheduler.waitFor(bulk);
+        }
+        std::cout << "Global Sum: " << globalSum << std::endl;
+    }
+
     static void BasicBenchmark() {
         std::atomic<size_t> completed = 0;
         {
@@ -83,6 +113,35 @@ public:
         InitScheduler();
         {
             ScopeTimer t("Scheduler Hash Benchmark With Alternate Wait For Completion", &results);
+            Reducer<size_t> sum(scheduler);
+            const size_t workers = scheduler.workerCount();
+
+            // Contiguous runs of chunks share an affinity key (= partition)
+            for (size_t i = 0; i < NUM_CHUNKS; ++i) {
+                scheduler.scheduleEvent(Event(i + 1, [i, &sum]() {
+                    size_t localSum = 0;
+                    size_t base = i * CHUNK_SIZE;
+                    for (size_t j = 0; j < CHUNK_SIZE; ++j) {
+                        int val = array[base + j];
+                        localSum += val * val + 17;
+                        localSum ^= (localSum << 3);
+                    }
+                    sum.local() += localSum % MOD;
+                }), i * workers / NUM_CHUNKS);
+            }
+            scheduler.markDone();
+            scheduler.waitUntilFinished();
+            globalSum.store(sum.combine());
+            std::cout << "Global Sum: " << globalSum << std::endl;
+        }
+    }
+
+    // SchedulerHash as it was, every chunk hitting the one shared atomic
+    static void SchedulerHashSharedAtomic(std::vector<long long>& results) {
+        globalSum.store(0);
+        InitScheduler();
+        {
+            ScopeTimer t("Scheduler Hash Benchmark With Shared Atomic Sum", &results);
 
             for (size_t i = 0; i < NUM_CHUNKS; ++i) {
                 scheduler.scheduleEvent(Event(i + 1, [i]() {
@@ -144,9 +203,32 @@ public:
         InitScheduler();
         {
             ScopeTimer t("Event Scheduler Benchmark", &results);
+            Reducer<size_t> sum(scheduler);
 
+            // Detached, so the first run doesn't pay for 1M fresh dependency
+            // rows and the two variants differ only in how they accumulate
             for (size_t i = 1; i <= NUM_EVENTS; ++i) {
-                scheduler.scheduleEvent(Event(i, [&]() {
+                scheduler.scheduleEvent(Event(Scheduler::DETACHED_ID, [&sum]() {
+                    volatile size_t x = 0;
+                    for (int j = 0; j < 100; ++j) x = x + j * j;
+                    sum.local() += x;
+                }));
+            }
+            scheduler.markDone();
+            scheduler.waitUntilFinished();
+            globalSum.store(sum.combine());
+        }
+        std::cout << "Global Sum: " << globalSum << std::endl;
+    }
+
+    static void EventSchedulerSharedAtomicBenchmark(std::vector<long long>& results) {
+        globalSum.store(0);
+        InitScheduler();
+        {
+            ScopeTimer t("Event Scheduler Benchmark With Shared Atomic Sum", &results);
+
+            for (size_t i = 1; i <= NUM_EVENTS; ++i) {
+                scheduler.scheduleEvent(Event(Scheduler::DETACHED_ID, [&]() {
                     volatile size_t x = 0;
                     for (int j = 0; j < 100; ++j) x += j * j;
                     globalSum.fetch_add(x);
@@ -205,8 +287,9 @@ public:
     
         {
             ScopeTimer t("Matrix Multiplication Scheduler Benchmark", &results);
+            const size_t workers = scheduler.workerCount();
             for (size_t i = 0; i < N; ++i) {
-                auto& row = C[i];
+                // Neighbouring rows land on the same worker
                 scheduler.scheduleEvent(Event(i, [i, &A, &B, &C]() {
                     size_t N = A.size();
                     auto &row = C[i];
@@ -217,7 +300,7 @@ public:
                         }
                         row[j] = sum;
                     }
-                }));
+                }), i * workers / N);
             }
             scheduler.markDone();
             scheduler.waitUntilFinished();
@@ -275,6 +358,273 @@ public:
         scheduler.markDone();
         scheduler.waitUntilFinished();
     }
+    // A search tree expanded while it runs: each node spawns its children
+    // and makes the join wait on them too. The last task is scheduled after
+    // the root has finished, that edge resolves on the spot.
+    static constexpr unsigned EXPAND_DEPTH = 6;
+    static constexpr unsigned EXPAND_FANOUT = 3;
+    static inline std::atomic<uint64_t> nextDynamicId = 0;
+    static inline std::atomic<size_t> expandedNodes = 0;
+
+    static void Expand(DependencyContext& ctx, unsigned depth, uint64_t join) {
+        expandedNodes.fetch_add(1, std::memory_order_relaxed);
+        if (depth == 0) return;
+        for (unsigned i = 0; i < EXPAND_FANOUT; ++i) {
+            uint64_t child = nextDynamicId.fetch_add(1, std::memory_order_relaxed);
+            ctx.spawn(child, [depth, join](DependencyContext& c) {
+                Expand(c, depth - 1, join);
+            });
+            scheduler.addDependency(child, join);
+        }
+    }
+
+    static void DynamicDependencyDemo() {
+        size_t expected = 0;
+        for (unsigned d = 0, level = 1; d <= EXPAND_DEPTH; ++d, level *= EXPAND_FANOUT)
+            expected += level;
+
+        // The same ids every run, each forgotten at the end: otherwise JOIN
+        // would be wired to last run's finished ROOT and start at once
+        constexpr uint64_t ROOT = uint64_t{1} << 40;
+        constexpr uint64_t JOIN = ROOT + 1;
+        constexpr uint64_t LATE = ROOT + 2;
+        nextDynamicId = LATE + 1;
+        InitScheduler();
+        expandedNodes = 0;
+        size_t seenByJoin = 0;
+        scheduler.scheduleEvent(JOIN, [&seenByJoin] {
+            seenByJoin = expandedNodes.load(std::memory_order_relaxed);
+        }, std::array<uint64_t, 1>{ROOT});
+        scheduler.scheduleEvent(ROOT, [JOIN](DependencyContext& ctx) {
+            Expand(ctx, EXPAND_DEPTH, JOIN);
+        }, {});
+        scheduler.markDone();
+        scheduler.waitUntilFinished();
+
+        bool lateRan = false;
+        scheduler.scheduleEvent(LATE, [&lateRan] { lateRan = true; },
+                                std::array<uint64_t, 1>{ROOT});
+        scheduler.waitUntilFinished();
+        for (uint64_t id = ROOT; id < nextDynamicId; ++id)
+            scheduler.forget(id);
+        std::cout << "Dynamic graph: join saw " << seenByJoin << " of " << expected
+                  << " expanded nodes, late child of finished root "
+                  << (lateRan ? "ran" : "never ran") << std::endl;
+    }
+
+    // Counts live instances, so the dataflow demo can show buffers going away
+    struct TrackedBuffer {
+        static inline std::atomic<long> live = 0;
+        static inline std::atomic<long> peak = 0;
+
+        explicit TrackedBuffer(size_t n, uint64_t fill = 0) : data(n, fill) { track(); }
+        TrackedBuffer(TrackedBuffer&& other) noexcept : data(std::move(other.data)) { track(); }
+        TrackedBuffer(const TrackedBuffer&) = delete;
+        ~TrackedBuffer() { live.fetch_sub(1, std::memory_order_relaxed); }
+
+        static void track() {
+            long now = live.fetch_add(1, std::memory_order_relaxed) + 1;
+            long seen = peak.load(std::memory_order_relaxed);
+            while (now > seen && !peak.compare_exchange_weak(seen, now)) {}
+        }
+
+        std::vector<uint64_t> data;
+    };
+
+    // Leaves fill buffers, a binary tree of typed tasks adds them pairwise.
+    // Every task reads its parents' buffers in place and each buffer is
+    // released as soon as the task consuming it has run.
+    static void DataflowReductionDemo() {
+        constexpr size_t LEAVES = 64;
+        constexpr size_t BUFFER = 4096;
+        const uint64_t base = uint64_t{1} << 41;
+        InitScheduler();
+        TrackedBuffer::peak = TrackedBuffer::live.load();
+
+        uint64_t next = base;
+        std::vector<TaskResult<TrackedBuffer>> level;
+        for (size_t i = 0; i < LEAVES; ++i) {
+            level.push_back(scheduler.scheduleEvent(next++, [i] {
+                return TrackedBuffer(BUFFER, i + 1);
+            }));
+        }
+        while (level.size() > 1) {
+            std::vector<TaskResult<TrackedBuffer>> up;
+            for (size_t i = 0; i + 1 < level.size(); i += 2) {
+                up.push_back(scheduler.scheduleEvent(next++,
+                    [](const TrackedBuffer& a, const TrackedBuffer& b) {
+                        TrackedBuffer sum(a.data.size());
+                        for (size_t j = 0; j < sum.data.size(); ++j)
+                            sum.data[j] = a.data[j] + b.data[j];
+                        return sum;
+                    }, level[i], level[i + 1]));
+            }
+            level = std::move(up);
+        }
+        TaskResult<uint64_t> total = scheduler.scheduleEvent(next++,
+            [](const TrackedBuffer& root) {
+                return std::accumulate(root.data.begin(), root.data.end(), uint64_t{0});
+            }, level.front());
+        level.clear();
+
+        scheduler.markDone();
+        scheduler.waitUntilFinished();
+        const uint64_t expected = BUFFER * LEAVES * (LEAVES + 1) / 2;
+        std::cout << "Dataflow reduction: total " << total.get() << " (expected "
+                  << expected << "), peak "
+                  << TrackedBuffer::peak << " live buffers, "
+                  << TrackedBuffer::live << " left" << std::endl;
+        Expect(total.get() == expected, "dataflow reduction total");
+        Expect(TrackedBuffer::live == 0, "dataflow reduction left buffers alive");
+        for (uint64_t id = base; id < next; ++id)
+            scheduler.forget(id);
+    }
+
+    // Same A→{B,D}→C shape as DependencyGraphDemo, resolved at compile time
+    static void StaticDependencyGraphDemo() {
+        enum : std::size_t { A, B, C, D };
+        InitScheduler();
+        auto graph = makeStaticGraph<Edges<Edge<A, B>, Edge<A, D>,
+                                           Edge<B, C>, Edge<D, C>>>(
+            [] {
+                std::lock_guard<std::mutex> lk(coutMutex);
+                std::cout << "[A] running (static)\n";
+            },
+            [] {
+                std::lock_guard<std::mutex> lk(coutMutex);
+                std::cout << "[B] running (static) after A\n";
+            },
+            [] {
+                std::lock_guard<std::mutex> lk(coutMutex);
+                std::cout << "[C] running (static) after B and D\n";
+            },
+            [] {
+                std::lock_guard<std::mutex> lk(coutMutex);
+                std::cout << "[D] running (static) after A\n";
+            });
+        graph.runAndWait(scheduler);
+    }
+
+    static void StaticGraphBenchmark(std::vector<long long>& results) {
+        constexpr size_t RUNS = 1'000;
+        enum : std::size_t { A, B, C, D };
+        globalSum.store(0);
+        InitScheduler();
+        auto work = [](size_t seed) {
+            volatile size_t x = seed;
+            for (int j = 0; j < 100; ++j) x = x ^ (x << 1);
+            globalSum.fetch_add(1, std::memory_order_relaxed);
+        };
+        auto graph = makeStaticGraph<Edges<Edge<A, B>, Edge<A, D>,
+                                           Edge<B, C>, Edge<D, C>>>(
+            [&work] { work(A); }, [&work] { work(B); },
+            [&work] { work(C); }, [&work] { work(D); });
+        {
+            ScopeTimer t("Static Graph Benchmark", &results);
+            for (size_t i = 0; i < RUNS; ++i) {
+                graph.runAndWait(scheduler);
+            }
+        }
+        std::cout << "Static Nodes Run: " << globalSum << std::endl;
+    }
+
+    // 64 events share a "disk" class with 2 tokens; the rest wait parked.
+    // Runs on a private pool with more workers than tokens (an elastic pool
+    // pinned at min == max), so a limiter that let extra events through
+    // would show up as a peak above TOKENS even on a single core machine.
+    static void ResourceClassDemo() {
+        constexpr size_t EVENTS = 64;
+        constexpr size_t TOKENS = 2;
+        std::atomic<size_t> inFlight = 0;
+        std::atomic<size_t> peak = 0;
+        ElasticConfig fixed;
+        fixed.minWorkers = fixed.maxWorkers = TOKENS + 2;
+        Scheduler pool;
+        ResourceClass disk = pool.addResourceClass("disk", TOKENS);
+        pool.start(fixed);
+
+        for (size_t i = 0; i < EVENTS; ++i) {
+            pool.scheduleEvent(Event(Scheduler::DETACHED_ID, [&inFlight, &peak] {
+                size_t now = inFlight.fetch_add(1) + 1;
+                size_t seen = peak.load();
+                while (now > seen && !peak.compare_exchange_weak(seen, now)) {}
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+                inFlight.fetch_sub(1);
+            }), disk);
+        }
+        pool.markDone();
+        pool.waitUntilFinished();
+        pool.stop();
+        std::cout << "Resource class 'disk': peak " << peak << " of " << TOKENS
+                  << " tokens across " << EVENTS << " events on "
+                  << fixed.maxWorkers << " workers" << std::endl;
+    }
+
+    // A private elastic pool: a burst of slow events should grow it past
+    // its minimum, and the extra workers retire once it has drained
+    static void ElasticPoolDemo() {
+        constexpr size_t EVENTS = 2'000;
+        ElasticConfig config;
+        config.minWorkers = 1;
+        config.maxWorkers = 4;
+        config.retireAfter = std::chrono::milliseconds(20);
+        Scheduler elastic;
+        elastic.start(config);
+
+        std::atomic<size_t> ran = 0;
+        for (size_t i = 0; i < EVENTS; ++i) {
+            elastic.scheduleEvent(Event(Scheduler::DETACHED_ID, [&ran] {
+                std::this_thread::sleep_for(std::chrono::microseconds(20));
+                ran.fetch_add(1, std::memory_order_relaxed);
+            }));
+        }
+        elastic.markDone();
+        elastic.waitUntilFinished();
+        SchedulerStats burst = elastic.stats();
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        SchedulerStats settled = elastic.stats();
+        elastic.stop();
+
+        Expect(ran == EVENTS, "elastic pool ran " + std::to_string(ran.load()) + " of " +
+                              std::to_string(EVENTS) + " events");
+
+        std::cout << "Elastic pool: ran " << ran << " events, grew to " << burst.peakWorkers
+                  << " of " << burst.maxWorkers << " workers (" << burst.scaleUps
+                  << " scale ups), " << settled.activeWorkers << " left after idling ("
+                  << settled.scaleDowns << " retired)" << std::endl;
+    }
+
+    // Pipe round trips through the reactor; completions come back as events
+    static void ReactorPipeBenchmark(std::vector<long long>& results) {
+        constexpr size_t ROUND_TRIPS = 1'000;
+        InitScheduler();
+        Reactor reactor(scheduler);
+        int fds[2];
+        if (::pipe(fds) != 0) return;
+
+        size_t bytes = 0;
+        {
+            ScopeTimer t(std::string("Reactor Pipe Benchmark (") +
+                         (reactor.backend() == Reactor::Backend::IoUring ? "io_uring" : "epoll") + ")",
+                         &results);
+            for (size_t i = 0; i < ROUND_TRIPS; ++i) {
+                char out = static_cast<char>(i), in = 0;
+                std::atomic<int> pending = 2;
+                reactor.read(fds[0], &in, 1, -1, [&](int64_t n) {
+                    bytes += n > 0 ? n : 0;
+                    pending.fetch_sub(1, std::memory_order_release);
+                });
+                reactor.write(fds[1], &out, 1, -1, [&](int64_t) {
+                    pending.fetch_sub(1, std::memory_order_release);
+                });
+                scheduler.waitFor([&] { return pending.load(std::memory_order_acquire) == 0; });
+            }
+        }
+        ::close(fds[0]);
+        ::close(fds[1]);
+        std::cout << "Reactor bytes read: " << bytes << std::endl;
+    }
+
     static void DeepDependencyBenchmark(std::vector<long long>& results) {
         constexpr size_t LEVELS = 100;
         constexpr size_t EVENTS_PER_LEVEL = 50;
@@ -329,7 +679,43 @@ public:
         }
     }
 
-    static void VerifyAll(int hashTrials = 1, int matrixTrials = 1, int dependencyTrials = 1) {
+    // Divide and conquer: each level forks the right half onto the worker's
+    // own deque, recurses into the left half and helps while it waits.
+    static size_t ForkJoinSum(size_t lo, size_t hi) {
+        if (hi - lo <= CHUNK_SIZE) {
+            size_t localSum = 0;
+            for (size_t j = lo; j < hi; ++j) localSum += array[j];
+            return localSum;
+        }
+        size_t mid = lo + (hi - lo) / 2;
+        size_t right = 0;
+        std::atomic<bool> rightDone = false;
+        scheduler.scheduleEvent(Event(mid + 1, [mid, hi, &right, &rightDone]() {
+            right = ForkJoinSum(mid, hi);
+            rightDone.store(true, std::memory_order_release);
+        }));
+        size_t left = ForkJoinSum(lo, mid);
+        scheduler.waitFor([&rightDone] {
+            return rightDone.load(std::memory_order_acquire);
+        });
+        return left + right;
+    }
+
+    static void RecursiveSumBenchmark(std::vector<long long>& results) {
+        size_t total = 0;
+        InitScheduler();
+        {
+            ScopeTimer t("Recursive Fork Join Sum Benchmark", &results);
+            scheduler.scheduleEvent(Event(DATA_SIZE + 1, [&total]() {
+                total = ForkJoinSum(0, DATA_SIZE);
+            }));
+            scheduler.markDone();
+            scheduler.waitUntilFinished();
+        }
+        std::cout << "Fork Join Sum: " << total << std::endl;
+    }
+
+    static int VerifyAll(int hashTrials = 1, int matrixTrials = 1, int dependencyTrials = 1) {
         std::vector<long long> results;
         for (int i = 0; i < hashTrials; i++) {
             BenchmarkHash(results);
@@ -341,6 +727,21 @@ public:
         }
         Summarize("Scheduler Hash", results);
         results.clear();
+        for (int i = 0; i < hashTrials; i++) {
+            SchedulerHashSharedAtomic(results);
+        }
+        Summarize("Scheduler Hash Shared Atomic", results);
+        results.clear();
+        for (int i = 0; i < hashTrials; i++) {
+            EventSchedulerBenchmark(results);
+        }
+        Summarize("Event Scheduler", results);
+        results.clear();
+        for (int i = 0; i < hashTrials; i++) {
+            EventSchedulerSharedAtomicBenchmark(results);
+        }
+        Summarize("Event Scheduler Shared Atomic", results);
+        results.clear();
         for (int i = 0; i < matrixTrials; i++) {
             MatrixMultiplicationBenchmark(100, results);
         }
@@ -352,9 +753,37 @@ public:
         Summarize("Matrix Multiplication Scheduler Benchmark", results);
         results.clear();
         DependencyGraphDemo();
+        StaticDependencyGraphDemo();
+        DynamicDependencyDemo();
+        DataflowReductionDemo();
+        ResourceClassDemo();
+        ElasticPoolDemo();
         for (int i = 0; i < dependencyTrials; i++) {
             DeepDependencyBenchmark(results);
         }
+        Summarize("Deep Dependency Benchmark", results);
+        results.clear();
+        for (int i = 0; i < dependencyTrials; i++) {
+            RecursiveSumBenchmark(results);
+        }
+        Summarize("Recursive Fork Join Sum Benchmark", results);
+        results.clear();
+        for (int i = 0; i < dependencyTrials; i++) {
+            StaticGraphBenchmark(results);
+        }
+        Summarize("Static Graph Benchmark", results);
+        results.clear();
+        for (int i = 0; i < hashTrials; i++) {
+            BulkScheduler(results);
+        }
+        Summarize("Bulk Scheduler Benchmark", results);
+        results.clear();
+        ReactorPipeBenchmark(results);
+        Summarize("Reactor Pipe Benchmark", results);
+#ifdef TELEMETRY_ENABLED
+        scheduler.hooks().report(std::cout);
+#endif
+        return failedChecks;
     }
 
 };
@@ -28,6 +28,20 @@ public:
         b.data.try_emplace(k, std::forward<Args>(args)...);
     }
 
+    // Shared lock on the hit path, exclusive only to insert. Elements are
+    // never moved by rehashing, so the reference stays valid until erase().
+    template<class... Args>
+    T& find_or_emplace(const Key& k, Args&&... args) {
+        Bucket& b = bucket_for(k);
+        {
+            std::shared_lock sl(b.m);
+            auto it = b.data.find(k);
+            if (it != b.data.end()) return it->second;
+        }
+        std::unique_lock lg(b.m);
+        return b.data.try_emplace(k, std::forward<Args>(args)...).first->second;
+    }
+
     template<class V>
     void insert_or_assign(const Key& k, V&& val) {
         Bucket& b = bucket_for(k);
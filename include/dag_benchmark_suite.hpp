@@ -0,0 +1,123 @@
+// dag_benchmark_suite.hpp
+#pragma once
+
+#include "../include/dag_generator.hpp"
+#include "../include/graph_replay.hpp"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <string>
+#include <algorithm>
+
+// Scheduler overhead across graph shapes.
+//
+// Each shape is replayed RUNS times with SpinKernel and the fastest run is
+// kept. With P = hardware_concurrency and the ideal time
+// max(work / P, span), the columns are:
+//   task ns    worker time beyond the ideal schedule, per node
+//   edge ns    what is left of that after subtracting the per-task cost
+//              measured on an edge-free graph of the same cost, per edge
+//   eff        work / (wall * P), parallel efficiency
+//   of bound   ideal / wall, how close to the best this shape allows
+class DagBenchmarkSuite {
+public:
+    struct Shape {
+        std::string name;
+        GraphData   graph;
+    };
+
+    static std::vector<Shape> Shapes(const CostModel& cost) {
+        std::vector<Shape> shapes;
+        shapes.push_back({"independent", makeIndependentDag(16'384, cost)});
+        shapes.push_back({"chain", makeChainDag(16'384, cost)});
+        shapes.push_back({"fan-out/in", makeFanOutInDag(16'382, cost)});
+        shapes.push_back({"diamonds", makeDiamondDag(5'461, cost)});
+        shapes.push_back({"erdos-renyi", makeErdosRenyiDag(4'096, 0.002, cost)});
+        shapes.push_back({"fork-join", makeForkJoinDag(13, cost)});
+        shapes.push_back({"stencil", makeStencilDag(128, 128, cost)});
+        return shapes;
+    }
+
+    struct Result {
+        double wall_ns = 0;
+        double lost_ns = 0;     // worker time beyond the ideal schedule
+    };
+
+    static Result Run(Scheduler& scheduler, const Shape& shape, int runs) {
+        const GraphView graph = shape.graph.view();
+        const DagProfile profile = profileDag(graph);
+        const double workers = Workers();
+        GraphReplay<> replay(graph);
+
+        double best = 0;
+        for (int r = 0; r < runs; ++r) {
+            auto start = std::chrono::steady_clock::now();
+            replay.runAndWait(scheduler);
+            double wall = std::chrono::duration<double, std::nano>(
+                std::chrono::steady_clock::now() - start).count();
+            if (r == 0 || wall < best) best = wall;
+        }
+
+        double ideal = std::max(profile.work_ns / workers,
+                                static_cast<double>(profile.span_ns));
+        Result result;
+        result.wall_ns = best;
+        result.lost_ns = std::max(0.0, best - ideal) * workers;
+        return result;
+    }
+
+    static void RunAll(const CostModel& cost, int runs = 5, const std::string& out_dir = "") {
+        Scheduler scheduler;
+        scheduler.start();
+        std::cout << "[DagBench] " << Workers() << " hardware threads, "
+                  << scheduler.workerCount() << " workers, " << cost.mean_ns
+                  << " ± " << cost.jitter_ns << " ns per task, best of " << runs << "\n";
+
+        double per_task = 0;
+        for (const Shape& shape : Shapes(cost)) {
+            const GraphView graph = shape.graph.view();
+            const DagProfile profile = profileDag(graph);
+            Result r = Run(scheduler, shape, runs);
+
+            double nodes = static_cast<double>(graph.node_count);
+            double task_ns = nodes ? r.lost_ns / nodes : 0;
+            if (graph.edge_count == 0) per_task = task_ns;
+            double ideal = std::max(profile.work_ns / Workers(),
+                                    static_cast<double>(profile.span_ns));
+
+            std::cout << "[DagBench] " << std::left << std::setw(12) << shape.name
+                      << std::right << " nodes=" << std::setw(6) << graph.node_count
+                      << " edges=" << std::setw(6) << graph.edge_count
+                      << " depth=" << std::setw(6) << profile.depth
+                      << std::fixed << std::setprecision(1)
+                      << "  wall=" << std::setw(9) << r.wall_ns / 1000 << " µs"
+                      << "  task=" << std::setw(7) << task_ns << " ns";
+            if (graph.edge_count > 0) {
+                double edge_ns = (r.lost_ns - per_task * nodes) / graph.edge_count;
+                std::cout << "  edge=" << std::setw(7) << edge_ns << " ns";
+            } else {
+                std::cout << "  edge=" << std::setw(7) << "-" << "   ";
+            }
+            std::cout << std::setprecision(2)
+                      << "  eff=" << profile.work_ns / (r.wall_ns * Workers())
+                      << "  of bound=" << ideal / r.wall_ns << "\n";
+
+            if (!out_dir.empty())
+                writeGraphFile(out_dir + "/" + FileName(shape.name) + ".bin", graph);
+        }
+        scheduler.stop();
+    }
+
+private:
+    static double Workers() {
+        unsigned n = std::thread::hardware_concurrency();
+        return n == 0 ? 1.0 : static_cast<double>(n);
+    }
+
+    static std::string FileName(std::string name) {
+        std::replace(name.begin(), name.end(), '/', '-');
+        return name;
+    }
+};
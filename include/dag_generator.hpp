@@ -0,0 +1,60 @@
+// dag_generator.hpp
+#ifndef DAG_GENERATOR_HPP
+#define DAG_GENERATOR_HPP
+
+#include "graph_file.hpp"
+
+#include <cstdint>
+
+// Synthetic task graphs in the standard shapes, for judging scheduler
+// changes across workloads rather than on a single benchmark graph.
+//
+// Every generator numbers its nodes so each edge goes from a lower id to a
+// higher one, i.e. id order is a valid topological order. The graphs can
+// be replayed directly with GraphReplay or written out with writeGraphFile.
+//
+// Node ids are 32 bit: a shape whose node count would exceed UINT32_MAX,
+// a cost model whose mean + jitter doesn't fit in 32 bits, or p outside
+// [0, 1] throws std::invalid_argument before anything is allocated.
+
+// Per-node cost, drawn uniformly from [mean - jitter, mean + jitter]
+struct CostModel {
+    uint32_t mean_ns   = 0;
+    uint32_t jitter_ns = 0;
+    uint64_t seed      = 1;
+};
+
+// n unconnected nodes, the baseline for per-task overhead
+GraphData makeIndependentDag(uint32_t nodes, const CostModel& cost);
+
+// 0 -> 1 -> ... -> length-1
+GraphData makeChainDag(uint32_t length, const CostModel& cost);
+
+// One source fanning out to width nodes that all fan back into one sink
+GraphData makeFanOutInDag(uint32_t width, const CostModel& cost);
+
+// count diamonds (a -> b, a -> c, b -> d, c -> d) chained through their tips
+GraphData makeDiamondDag(uint32_t count, const CostModel& cost);
+
+// Erdős–Rényi over the nodes' id order: each pair i < j is an edge with
+// probability p. Uses geometric skips, so the cost is in the edges, not n².
+GraphData makeErdosRenyiDag(uint32_t nodes, double p, const CostModel& cost);
+
+// Binary fork tree with 2^depth leaves, mirrored by a join tree
+// (3 * 2^depth - 2 nodes, so depth <= 30)
+GraphData makeForkJoinDag(uint32_t depth, const CostModel& cost);
+
+// 1D three-point stencil over time: cell (t, x) waits on (t-1, x-1..x+1)
+GraphData makeStencilDag(uint32_t width, uint32_t steps, const CostModel& cost);
+
+// Total recorded work, critical path length and depth (nodes on the
+// longest path) of an acyclic graph
+struct DagProfile {
+    uint64_t work_ns = 0;
+    uint64_t span_ns = 0;
+    uint64_t depth   = 0;
+};
+
+DagProfile profileDag(const GraphView& graph);
+
+#endif
@@ -6,6 +6,7 @@
 #include <cstdint>
 #include <string>
 #include <cstring>
+#include <cstddef>
 
 class OldEvent {
 public:
@@ -51,6 +52,8 @@ class Event {
     
         Event(Event&& other) noexcept
             : event_id(other.event_id),
+              resource_class(other.resource_class),
+              holds_token(other.holds_token),
               event_name(std::move(other.event_name)),
               invoke(other.invoke),
               destroy(other.destroy) {
@@ -64,6 +67,8 @@ class Event {
                 reset();
     
                 event_id = other.event_id;
+                resource_class = other.resource_class;
+                holds_token = other.holds_token;
                 event_name = std::move(other.event_name);
                 invoke = other.invoke;
                 destroy = other.destroy;
@@ -85,6 +90,13 @@ class Event {
     
         uint64_t getId() const { return event_id; }
         std::string getName() const { return event_name; }
+
+        // Concurrency-limited class this event needs a token of, 0 = none
+        uint32_t getResourceClass() const { return resource_class; }
+        void setResourceClass(uint32_t cls) { resource_class = cls; }
+        // Set once the token is taken, so a parked event isn't charged twice
+        bool holdsToken() const { return holds_token; }
+        void setHoldsToken(bool held) { holds_token = held; }
     
     
     private:
@@ -95,6 +107,8 @@ class Event {
         }
     
         uint64_t event_id = 0;
+        uint32_t resource_class = 0;
+        bool holds_token = false;
         std::string event_name;
     
         // Function pointer for calling the stored callable
@@ -0,0 +1,92 @@
+// graph_file.hpp
+#ifndef GRAPH_FILE_HPP
+#define GRAPH_FILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Binary task graph format (little endian, every section 8-byte aligned)
+//
+//   GraphFileHeader                      72 bytes
+//   uint64_t offsets   [node_count + 1]  CSR row starts into targets
+//   uint32_t targets   [edge_count]      successor node ids
+//   uint32_t in_degree [node_count]      precomputed, so loading never
+//                                        has to walk the edges
+//   uint32_t cost_ns   [node_count]      recorded duration of each node
+//   uint16_t kernel    [node_count]      kernel id, 0 = plain spin
+//
+// The section offsets in the header are byte offsets from the start of
+// the file, so a mapped file is used in place without any parsing.
+struct GraphFileHeader {
+    char     magic[8];          // "EVSGRAPH"
+    uint32_t version;
+    uint32_t flags;
+    uint64_t node_count;
+    uint64_t edge_count;
+    uint64_t offsets_offset;
+    uint64_t targets_offset;
+    uint64_t in_degree_offset;
+    uint64_t cost_offset;
+    uint64_t kernel_offset;
+};
+static_assert(sizeof(GraphFileHeader) == 72, "header layout is part of the format");
+
+inline constexpr char     GRAPH_FILE_MAGIC[8] = {'E', 'V', 'S', 'G', 'R', 'A', 'P', 'H'};
+inline constexpr uint32_t GRAPH_FILE_VERSION  = 1;
+
+// Non-owning CSR view, backed either by a mapped file or by vectors
+struct GraphView {
+    uint64_t        node_count = 0;
+    uint64_t        edge_count = 0;
+    const uint64_t* offsets    = nullptr;
+    const uint32_t* targets    = nullptr;
+    const uint32_t* in_degree  = nullptr;
+    const uint32_t* cost_ns    = nullptr;
+    const uint16_t* kernel     = nullptr;
+};
+
+// In-memory graph, what the converter and generators build before writing
+struct GraphData {
+    std::vector<uint64_t> offsets{0};
+    std::vector<uint32_t> targets;
+    std::vector<uint32_t> in_degree;
+    std::vector<uint32_t> cost_ns;
+    std::vector<uint16_t> kernel;
+
+    // Builds CSR arrays from an unordered edge list; cost/kernel must
+    // already be sized to node_count.
+    static GraphData fromEdges(uint64_t node_count,
+                               const std::vector<std::pair<uint32_t, uint32_t>>& edges,
+                               std::vector<uint32_t> cost_ns,
+                               std::vector<uint16_t> kernel);
+
+    GraphView view() const;
+    bool isAcyclic() const;
+};
+
+// Read-only memory mapping of a graph file. Throws std::runtime_error if
+// the file can't be mapped, its header doesn't describe a valid layout, or
+// its contents aren't a well formed DAG (offsets monotonic and ending at
+// edge_count, every target below node_count, in_degree matching the edges,
+// no cycle). Loading is O(nodes + edges) for that check.
+class GraphFile {
+public:
+    explicit GraphFile(const std::string& path);
+    ~GraphFile();
+
+    GraphFile(const GraphFile&) = delete;
+    GraphFile& operator=(const GraphFile&) = delete;
+
+    const GraphView& view() const { return view_; }
+
+private:
+    void*       data_ = nullptr;
+    std::size_t size_ = 0;
+    GraphView   view_;
+};
+
+void writeGraphFile(const std::string& path, const GraphView& graph);
+
+#endif
@@ -0,0 +1,86 @@
+// graph_replay.hpp
+#ifndef GRAPH_REPLAY_HPP
+#define GRAPH_REPLAY_HPP
+
+#include "scheduler.hpp"
+#include "graph_file.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+// Default replay kernel: busy-waits for the node's recorded duration
+struct SpinKernel {
+    void operator()(uint32_t /*node*/, uint16_t /*kernel*/, uint32_t cost_ns) const {
+        if (cost_ns == 0) return;
+        auto until = std::chrono::steady_clock::now() + std::chrono::nanoseconds(cost_ns);
+        while (std::chrono::steady_clock::now() < until) {}
+    }
+};
+
+// Executes a CSR graph (usually a mapped GraphFile) on the Scheduler.
+//
+// Edges are read straight out of the view; the only state is one atomic
+// counter per node, allocated once with the replay and reset per run.
+// Roots are found by a bulk scan of in_degree, so a wide graph is not
+// pushed through the shared ring one node at a time. Readied successors
+// go onto the finishing worker's deque as untracked events.
+template<typename Kernel = SpinKernel>
+class GraphReplay {
+public:
+    explicit GraphReplay(const GraphView& graph, Kernel kernel = Kernel{})
+        : graph_(graph), kernel_(kernel),
+          pending_(new std::atomic<uint32_t>[graph.node_count]) {}
+
+    GraphReplay(const GraphReplay&) = delete;
+    GraphReplay& operator=(const GraphReplay&) = delete;
+
+    void run(Scheduler& scheduler) {
+        assert(finished() && "replay already running");
+        scheduler_ = &scheduler;
+        for (uint64_t n = 0; n < graph_.node_count; ++n)
+            pending_[n].store(graph_.in_degree[n], std::memory_order_relaxed);
+        remaining_.store(graph_.node_count, std::memory_order_release);
+
+        scheduler.scheduleBulk(Scheduler::DETACHED_ID, 0, graph_.node_count,
+            [this](std::size_t n) {
+                if (graph_.in_degree[n] == 0) execute(static_cast<uint32_t>(n));
+            });
+    }
+
+    bool finished() const {
+        return remaining_.load(std::memory_order_acquire) == 0;
+    }
+
+    void wait(Scheduler& scheduler) {
+        scheduler.waitFor([this] { return finished(); });
+    }
+
+    void runAndWait(Scheduler& scheduler) {
+        run(scheduler);
+        wait(scheduler);
+    }
+
+private:
+    void execute(uint32_t n) {
+        kernel_(n, graph_.kernel[n], graph_.cost_ns[n]);
+        for (uint64_t k = graph_.offsets[n]; k < graph_.offsets[n + 1]; ++k) {
+            uint32_t s = graph_.targets[k];
+            if (pending_[s].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                scheduler_->scheduleEvent(Event(Scheduler::DETACHED_ID, [this, s]() {
+                    execute(s);
+                }));
+            }
+        }
+        remaining_.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    GraphView                                graph_;
+    Kernel                                   kernel_;
+    Scheduler*                               scheduler_ = nullptr;
+    std::unique_ptr<std::atomic<uint32_t>[]> pending_;
+    alignas(64) std::atomic<uint64_t>        remaining_{0};
+};
+
+#endif
@@ -40,12 +40,14 @@ class SeqRing final : public LockFreeQueue<T>
 public:
     explicit SeqRing(std::size_t capacity);
     void push(T&& element) override; // move
+    bool tryPush(T&& element);       // element untouched if the ring is full
     std::optional<T> pop() override;
 
     template<std::size_t Capacity, typename OutputIt>
     std::size_t pop_batch(OutputIt out);
 
     void setWorkerCount(unsigned workers);
+    std::size_t sizeApprox() const;
 
     ~SeqRing() override;
 
@@ -60,7 +62,7 @@ private:
     /* helpers */
     static std::size_t nextPow2(std::size_t n);
     template<typename U>
-    void produce(U&& element);
+    bool produce(U&& element, bool wait_if_full);
     std::optional<T> consume();
     /* data members */
     const std::size_t      capacity_;   // power of two
@@ -69,7 +71,44 @@ private:
     std::size_t divshift;
 
     alignas(64) std::atomic<uint64_t> head_{0};   // written by consumers
-    alignas(64) std::atomic<uint64_t> tail_{0};   // written by producer
+    alignas(64) std::atomic<uint64_t> tail_{0};   // written by producers
+};
+
+// Class for a per-worker "Work Stealing Deque" (Chase-Lev over a fixed ring)
+//
+// The owning worker pushes and pops at the bottom (LIFO, keeps the most
+// recently spawned work hot in cache); any other thread steals from the top.
+// Slots are only touched after the index has been claimed, so T does not
+// need to be trivially copyable. push() fails instead of dropping when full.
+template <typename T>
+class WorkStealingDeque
+{
+public:
+    explicit WorkStealingDeque(std::size_t capacity);
+    ~WorkStealingDeque();
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    bool push(T&& element);         // owner only, element untouched on failure
+    std::optional<T> pop();         // owner only
+    std::optional<T> steal();       // any thread
+    std::size_t sizeApprox() const;
+
+private:
+    struct Cell {
+        std::atomic<bool> full{false};  // cleared once the taker moved out
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+    };
+
+    T take(Cell& cell);
+
+    const std::size_t      capacity_;   // power of two
+    const std::size_t      mask_;
+    std::vector<Cell>      buffer_;
+
+    alignas(64) std::atomic<int64_t> top_{0};      // advanced by thieves
+    alignas(64) std::atomic<int64_t> bottom_{0};   // written by owner
 };
 
 #include "lock_free_queue.tpp"
@@ -10,6 +10,8 @@
 #include <vector>
 #include <thread>
 #include <cassert>
+#include <bit>
+#include <algorithm>
 template<typename T>
 SPMC<T>::SPMC(size_t cap)
     : buffer(cap), capacity(cap), head(0), tail(0) {}
@@ -98,12 +100,17 @@ SeqRing<T>::~SeqRing(){
 
 template<typename T>
 void SeqRing<T>::push(T&& elem) { 
-    produce(std::move(elem)); 
+    produce(std::move(elem), true); 
+}
+
+template<typename T>
+bool SeqRing<T>::tryPush(T&& elem) {
+    return produce(std::move(elem), false);
 }
 
 template<typename T>
 template<typename U>
-inline void SeqRing<T>::produce(U&& value) {
+inline bool SeqRing<T>::produce(U&& value, bool wait_if_full) {
     while (true) {
         uint64_t tail = tail_.load(std::memory_order_relaxed);
         Cell&    cell = buffer_[tail & mask_];
@@ -113,19 +120,24 @@ inline void SeqRing<T>::produce(U&& value) {
                         static_cast<intptr_t>(tail);
 
         if (diff == 0) {                          /* slot free */
+            // Claim the slot first: workers, the reactor and external
+            // threads may all push concurrently.
+            if (!tail_.compare_exchange_weak(
+                    tail, tail + 1,
+                    std::memory_order_relaxed,
+                    std::memory_order_relaxed))
+                continue;
+
             std::construct_at(
                 reinterpret_cast<T*>(&cell.storage),
                 std::forward<U>(value));
 
             cell.seq.store(tail + 1, std::memory_order_release);
-            tail_.store(tail + 1, std::memory_order_relaxed);
-            return;
+            return true;
         }
 
         else if (diff < 0) {          
-            #ifdef TELEMETRY_ENABLED                 
-            std::cout << "DIFF < 0" << std::endl;
-            #endif 
+            if (!wait_if_full) return false;
             std::this_thread::yield();
         } /* else: consumer still reading – retry */
     }
@@ -173,16 +185,23 @@ inline std::optional<T> SeqRing<T>::pop() {
 //Happens once, upon the scheduler initialization
 template<typename T>
 void SeqRing<T>::setWorkerCount(unsigned workers) {
-    divshift = nextPow2(workers);
+    divshift = workers < 2 ? 1 : nextPow2(workers);
     divshift = divshift < 1 ? 1 : divshift;
     divshift = divshift > 16 ? 16 : divshift;
 }
 
+template<typename T>
+std::size_t SeqRing<T>::sizeApprox() const {
+    uint64_t h = head_.load(std::memory_order_relaxed);
+    uint64_t t = tail_.load(std::memory_order_relaxed);
+    return t > h ? static_cast<std::size_t>(t - h) : 0;
+}
+
 template<typename T>
 template<std::size_t Capacity, typename OutputIt>
 std::size_t SeqRing<T>::pop_batch(OutputIt out) {
-    static_assert(Capacity >= 16,
-                  "buffer must hold at least the max automatic batch");
+    // Capacity doubles as the largest batch taken in one go
+    static_assert(Capacity >= 1, "batch buffer must hold at least one item");
 
     uint64_t head = head_.load(std::memory_order_acquire);
     uint64_t tail = tail_.load(std::memory_order_acquire);
@@ -190,7 +209,7 @@ std::size_t SeqRing<T>::pop_batch(OutputIt out) {
     if (avail == 0) return 0;
 
     std::size_t k = avail >> divshift;
-    k = std::min<std::size_t>(16, std::max<std::size_t>(1, k));
+    k = std::min<std::size_t>(Capacity, std::max<std::size_t>(1, k));
 
     // Try to peek ahead and count how many items are actually ready
     std::size_t ready = 0;
@@ -225,3 +244,92 @@ std::size_t SeqRing<T>::pop_batch(OutputIt out) {
 
     return ready;
 }
+
+// ------- WORK STEALING DEQUE IMPLEMENTATION --------
+
+template<typename T>
+WorkStealingDeque<T>::WorkStealingDeque(std::size_t cap)
+    : capacity_(std::bit_ceil(cap < 2 ? std::size_t{2} : cap)),
+      mask_    (capacity_ - 1),
+      buffer_  (capacity_) {}
+
+template<typename T>
+WorkStealingDeque<T>::~WorkStealingDeque() {
+    int64_t t = top_.load(std::memory_order_relaxed);
+    int64_t b = bottom_.load(std::memory_order_relaxed);
+    for (; t < b; ++t)
+        std::launder(reinterpret_cast<T*>(&buffer_[t & mask_].storage))->~T();
+}
+
+template<typename T>
+inline T WorkStealingDeque<T>::take(Cell& cell) {
+    T* ptr = std::launder(reinterpret_cast<T*>(&cell.storage));
+    T out{ std::move(*ptr) };
+    ptr->~T();
+    cell.full.store(false, std::memory_order_release);
+    return out;
+}
+
+template<typename T>
+bool WorkStealingDeque<T>::push(T&& elem) {
+    int64_t b = bottom_.load(std::memory_order_relaxed);
+    int64_t t = top_.load(std::memory_order_acquire);
+    if (b - t >= static_cast<int64_t>(capacity_))
+        return false;
+
+    Cell& cell = buffer_[b & mask_];
+    // A thief may have claimed this slot one lap ago and still be moving out
+    while (cell.full.load(std::memory_order_acquire))
+        std::this_thread::yield();
+
+    std::construct_at(reinterpret_cast<T*>(&cell.storage), std::move(elem));
+    cell.full.store(true, std::memory_order_relaxed);
+    bottom_.store(b + 1, std::memory_order_release);
+    return true;
+}
+
+template<typename T>
+std::optional<T> WorkStealingDeque<T>::pop() {
+    int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+    bottom_.store(b, std::memory_order_release);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top_.load(std::memory_order_relaxed);
+
+    if (t > b) {                                  /* empty */
+        bottom_.store(b + 1, std::memory_order_release);
+        return std::nullopt;
+    }
+    if (t == b) {                                 /* last one, race thieves */
+        bool won = top_.compare_exchange_strong(
+            t, t + 1,
+            std::memory_order_seq_cst,
+            std::memory_order_relaxed);
+        bottom_.store(b + 1, std::memory_order_release);
+        if (!won) return std::nullopt;
+    }
+    return take(buffer_[b & mask_]);
+}
+
+template<typename T>
+std::optional<T> WorkStealingDeque<T>::steal() {
+    int64_t t = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t b = bottom_.load(std::memory_order_acquire);
+    if (t >= b)
+        return std::nullopt;
+
+    if (!top_.compare_exchange_strong(
+            t, t + 1,
+            std::memory_order_seq_cst,
+            std::memory_order_relaxed))
+        return std::nullopt;                      /* lost to owner / thief */
+
+    return take(buffer_[t & mask_]);
+}
+
+template<typename T>
+std::size_t WorkStealingDeque<T>::sizeApprox() const {
+    int64_t b = bottom_.load(std::memory_order_relaxed);
+    int64_t t = top_.load(std::memory_order_relaxed);
+    return b > t ? static_cast<std::size_t>(b - t) : 0;
+}
@@ -0,0 +1,242 @@
+// queue_benchmark_suite.hpp
+#pragma once
+
+#include "../include/lock_free_queue.hpp"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <array>
+#include <string>
+#include <algorithm>
+
+// Queue microbenchmarks, independent of the scheduler.
+//
+// Every run pushes OPS payloads through one queue from P producer threads
+// and drains them with C consumer threads. Throughput is OPS over the wall
+// time of the whole run. The latency columns are the cost of individual
+// calls: every SAMPLE_EVERY-th push on each producer, and every
+// SAMPLE_EVERY-th pop call that returned something on each consumer (a
+// whole batch for pop_batch), timed with steady_clock around the call.
+// Time a payload spends queued is deliberately not part of it. Producers
+// run unpaced, so a push that finds the ring full waits for a slot and
+// that backpressure shows up in the push tail.
+class QueueBenchmarkSuite {
+public:
+    static constexpr size_t OPS = 1 << 17;
+    static constexpr size_t RING_CAPACITY = 1 << 16;
+    static constexpr size_t SAMPLE_EVERY = 16;
+
+    template<size_t Size>
+    struct Payload {
+        static_assert(Size >= sizeof(int64_t), "payload must fit the sequence number");
+        int64_t seq = 0;
+        std::array<unsigned char, Size - sizeof(int64_t)> bytes{};
+    };
+
+    // SPMC drops on overflow, so it is sized to never fill up
+    template<typename T>
+    struct SPMCAdapter {
+        static constexpr bool MULTI_PRODUCER = false;
+        static std::string name() { return "SPMC::pop"; }
+
+        explicit SPMCAdapter(size_t ops) : queue(ops + 1) {}
+        void push(T&& value) { queue.push(std::move(value)); }
+
+        template<typename Sink>
+        size_t consume(Sink&& sink) {
+            std::optional<T> value = queue.pop();
+            if (!value) return 0;
+            sink(*value);
+            return 1;
+        }
+
+        SPMC<T> queue;
+    };
+
+    template<typename T>
+    struct SeqRingAdapter {
+        static constexpr bool MULTI_PRODUCER = true;
+        static std::string name() { return "SeqRing::pop"; }
+
+        explicit SeqRingAdapter(size_t) : queue(RING_CAPACITY) {}
+        void push(T&& value) { queue.push(std::move(value)); }
+
+        template<typename Sink>
+        size_t consume(Sink&& sink) {
+            std::optional<T> value = queue.pop();
+            if (!value) return 0;
+            sink(*value);
+            return 1;
+        }
+
+        SeqRing<T> queue;
+    };
+
+    template<typename T, size_t Batch>
+    struct SeqRingBatchAdapter {
+        static constexpr bool MULTI_PRODUCER = true;
+        static std::string name() {
+            return "SeqRing::pop_batch<" + std::to_string(Batch) + ">";
+        }
+
+        explicit SeqRingBatchAdapter(size_t) : queue(RING_CAPACITY) {
+            queue.setWorkerCount(1);
+        }
+        void push(T&& value) { queue.push(std::move(value)); }
+
+        template<typename Sink>
+        size_t consume(Sink&& sink) {
+            std::array<T, Batch> buf;
+            size_t got = queue.template pop_batch<Batch>(buf.begin());
+            for (size_t i = 0; i < got; ++i) sink(buf[i]);
+            return got;
+        }
+
+        SeqRing<T> queue;
+    };
+
+    // The single producer is the owning worker, consumers are thieves
+    template<typename T>
+    struct StealAdapter {
+        static constexpr bool MULTI_PRODUCER = false;
+        static std::string name() { return "WorkStealingDeque::steal"; }
+
+        explicit StealAdapter(size_t) : queue(RING_CAPACITY) {}
+        void push(T&& value) {
+            while (!queue.push(std::move(value))) std::this_thread::yield();
+        }
+
+        template<typename Sink>
+        size_t consume(Sink&& sink) {
+            std::optional<T> value = queue.steal();
+            if (!value) return 0;
+            sink(*value);
+            return 1;
+        }
+
+        WorkStealingDeque<T> queue;
+    };
+
+    template<typename Queue, size_t PayloadSize>
+    static void Run(size_t producers, size_t consumers) {
+        using T = Payload<PayloadSize>;
+        if (producers > 1 && !Queue::MULTI_PRODUCER) return;
+
+        Queue queue(OPS);
+        std::atomic<bool> go = false;
+        std::atomic<size_t> consumed = 0;
+        std::vector<std::vector<int64_t>> pushTimes(producers);
+        std::vector<std::vector<int64_t>> popTimes(consumers);
+        std::vector<std::thread> threads;
+
+        for (size_t p = 0; p < producers; ++p) {
+            size_t share = OPS / producers + (p < OPS % producers ? 1 : 0);
+            std::vector<int64_t>& samples = pushTimes[p];
+            samples.reserve(share / SAMPLE_EVERY + 1);
+            threads.emplace_back([&queue, &go, &samples, share] {
+                while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+                for (size_t i = 0; i < share; ++i) {
+                    T value;
+                    value.seq = static_cast<int64_t>(i);
+                    if (i % SAMPLE_EVERY != 0) {
+                        queue.push(std::move(value));
+                        continue;
+                    }
+                    int64_t before = Now();
+                    queue.push(std::move(value));
+                    samples.push_back(Now() - before);
+                }
+            });
+        }
+        for (size_t c = 0; c < consumers; ++c) {
+            std::vector<int64_t>& samples = popTimes[c];
+            samples.reserve(OPS / SAMPLE_EVERY + 1);
+            threads.emplace_back([&queue, &go, &consumed, &samples] {
+                auto sink = [](const T& value) { DoNotOptimize(value.seq); };
+                size_t calls = 0;
+                while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+                while (consumed.load(std::memory_order_relaxed) < OPS) {
+                    bool timed = calls % SAMPLE_EVERY == 0;
+                    int64_t before = timed ? Now() : 0;
+                    size_t got = queue.consume(sink);
+                    if (got == 0) {
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    if (timed) samples.push_back(Now() - before);
+                    ++calls;
+                    consumed.fetch_add(got, std::memory_order_relaxed);
+                }
+            });
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        go.store(true, std::memory_order_release);
+        for (std::thread& t : threads) t.join();
+        auto end = std::chrono::steady_clock::now();
+
+        std::vector<int64_t> push = Merge(pushTimes);
+        std::vector<int64_t> pop = Merge(popTimes);
+
+        double seconds = std::chrono::duration<double>(end - start).count();
+        std::cout << "[QueueBench] " << std::left << std::setw(28) << Queue::name()
+                  << " P=" << producers << " C=" << consumers
+                  << " payload=" << std::setw(5) << (std::to_string(PayloadSize) + "B")
+                  << std::fixed << std::setprecision(2)
+                  << (OPS / seconds) / 1e6 << " Mops/s"
+                  << "  push p50/p99/p99.9=" << Percentile(push, 0.50) << "/"
+                  << Percentile(push, 0.99) << "/" << Percentile(push, 0.999) << "ns"
+                  << "  pop p50/p99/p99.9=" << Percentile(pop, 0.50) << "/"
+                  << Percentile(pop, 0.99) << "/" << Percentile(pop, 0.999) << "ns\n";
+    }
+
+    template<size_t PayloadSize>
+    static void RunPayload(const std::vector<std::pair<size_t, size_t>>& shapes) {
+        using T = Payload<PayloadSize>;
+        for (auto [p, c] : shapes) {
+            Run<SPMCAdapter<T>, PayloadSize>(p, c);
+            Run<SeqRingAdapter<T>, PayloadSize>(p, c);
+            Run<SeqRingBatchAdapter<T, 4>, PayloadSize>(p, c);
+            Run<SeqRingBatchAdapter<T, 16>, PayloadSize>(p, c);
+            Run<SeqRingBatchAdapter<T, 64>, PayloadSize>(p, c);
+            Run<StealAdapter<T>, PayloadSize>(p, c);
+        }
+    }
+
+    static void RunAll() {
+        const std::vector<std::pair<size_t, size_t>> shapes = {
+            {1, 1}, {1, 4}, {4, 1}, {4, 4},
+        };
+        RunPayload<8>(shapes);
+        RunPayload<64>(shapes);
+        RunPayload<256>(shapes);
+    }
+
+private:
+    static int64_t Now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    template<typename V>
+    static void DoNotOptimize(const V& value) {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    static std::vector<int64_t> Merge(const std::vector<std::vector<int64_t>>& perThread) {
+        std::vector<int64_t> all;
+        for (const auto& samples : perThread)
+            all.insert(all.end(), samples.begin(), samples.end());
+        std::sort(all.begin(), all.end());
+        return all;
+    }
+
+    static int64_t Percentile(const std::vector<int64_t>& sorted, double q) {
+        if (sorted.empty()) return 0;
+        size_t idx = static_cast<size_t>(q * (sorted.size() - 1));
+        return sorted[idx];
+    }
+};
@@ -0,0 +1,179 @@
+// reactor.hpp
+#ifndef REACTOR_HPP
+#define REACTOR_HPP
+
+#include "scheduler.hpp"
+#include "lock_free_queue.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <utility>
+
+enum class IoOp : uint8_t { Read, Write, Accept, Timeout };
+
+// One asynchronous operation. The reactor fills in `result` (bytes moved,
+// accepted fd, 0 for an expired timeout, or -errno) and then runs
+// complete(this) as an untracked event on the scheduler.
+struct IoRequest {
+    IoOp        op = IoOp::Read;
+    int         fd = -1;
+    void*       buf = nullptr;
+    std::size_t len = 0;
+    int64_t     offset = -1;        // < 0: current position / not seekable
+    int64_t     timeout_ns = 0;
+    int64_t     timespec[2] = {};   // kernel timespec for io_uring timeouts
+    int64_t     result = 0;
+    void      (*complete)(IoRequest*) = nullptr;
+};
+
+class ReactorBackend;
+
+// Asynchronous I/O for the Scheduler
+//
+// A dedicated reactor thread owns an io_uring instance (or, where io_uring
+// is unavailable or not wanted, an epoll set plus a timer heap; regular
+// files are then read and written on the reactor thread, since epoll can't
+// wait on them). Workers only ever enqueue requests, they never block in a
+// syscall. Completions are harvested in batches and handed to the scheduler
+// as ready events: either a callback taking the int64_t result, or the
+// resumption of a coroutine (e.g. a Task from external/Task.hpp) that
+// co_awaited the operation.
+//
+// Buffers must stay valid until completion. Destroying the reactor cancels
+// whatever is still outstanding: those requests complete with -ECANCELED
+// (or their real result, if they finished first), and the destructor
+// returns once every completion has run. Destroy it before stopping the
+// scheduler, which has to run those completions.
+//
+// Scheduler::waitUntilFinished() only counts scheduled events, not I/O in
+// flight: it can return while a read is still pending and its callback not
+// yet scheduled. Wait for outstanding() == 0 as well when that matters.
+class Reactor {
+public:
+    enum class Backend { IoUring, Epoll };
+
+    explicit Reactor(Scheduler& scheduler, Backend preferred = Backend::IoUring,
+                     unsigned queue_depth = 256);
+    ~Reactor();
+
+    Reactor(const Reactor&) = delete;
+    Reactor& operator=(const Reactor&) = delete;
+
+    Backend backend() const { return backend_kind_; }
+
+    // Requests submitted whose completion hasn't finished running yet
+    std::size_t outstanding() const {
+        return outstanding_.load(std::memory_order_acquire);
+    }
+
+    // Low level: the request must live until complete() has run
+    void submit(IoRequest* request);
+
+    // Callback style, on_done(int64_t result) runs as an event
+    template<typename Fn>
+    void read(int fd, void* buf, std::size_t len, int64_t offset, Fn&& on_done) {
+        submitCallback(IoOp::Read, fd, buf, len, offset, 0, std::forward<Fn>(on_done));
+    }
+    template<typename Fn>
+    void write(int fd, const void* buf, std::size_t len, int64_t offset, Fn&& on_done) {
+        submitCallback(IoOp::Write, fd, const_cast<void*>(buf), len, offset, 0,
+                       std::forward<Fn>(on_done));
+    }
+    template<typename Fn>
+    void accept(int fd, Fn&& on_done) {
+        submitCallback(IoOp::Accept, fd, nullptr, 0, -1, 0, std::forward<Fn>(on_done));
+    }
+    template<typename Fn>
+    void timeout(std::chrono::nanoseconds after, Fn&& on_done) {
+        submitCallback(IoOp::Timeout, -1, nullptr, 0, -1, after.count(),
+                       std::forward<Fn>(on_done));
+    }
+
+    // Coroutine style, `int64_t n = co_await reactor.read(...)`. The
+    // awaiting coroutine is resumed on a worker.
+    struct [[nodiscard]] Awaiter : IoRequest {
+        Reactor*                reactor = nullptr;
+        std::coroutine_handle<> waiter;
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h) {
+            waiter = h;
+            complete = [](IoRequest* r) { static_cast<Awaiter*>(r)->waiter.resume(); };
+            reactor->submit(this);
+        }
+        int64_t await_resume() const noexcept { return result; }
+    };
+
+    Awaiter read(int fd, void* buf, std::size_t len, int64_t offset = -1) {
+        return makeAwaiter(IoOp::Read, fd, buf, len, offset, 0);
+    }
+    Awaiter write(int fd, const void* buf, std::size_t len, int64_t offset = -1) {
+        return makeAwaiter(IoOp::Write, fd, const_cast<void*>(buf), len, offset, 0);
+    }
+    Awaiter accept(int fd) {
+        return makeAwaiter(IoOp::Accept, fd, nullptr, 0, -1, 0);
+    }
+    Awaiter timeout(std::chrono::nanoseconds after) {
+        return makeAwaiter(IoOp::Timeout, -1, nullptr, 0, -1, after.count());
+    }
+
+private:
+    static constexpr std::size_t SUBMIT_QUEUE_CAPACITY = 4096;
+    static constexpr std::size_t MAX_BATCH = 64;
+
+    template<typename Fn>
+    struct CallbackRequest : IoRequest {
+        explicit CallbackRequest(Fn&& f) : fn(std::forward<Fn>(f)) {}
+        std::decay_t<Fn> fn;
+    };
+
+    template<typename Fn>
+    void submitCallback(IoOp op, int fd, void* buf, std::size_t len,
+                        int64_t offset, int64_t timeout_ns, Fn&& on_done) {
+        auto* req = new CallbackRequest<Fn>(std::forward<Fn>(on_done));
+        fill(*req, op, fd, buf, len, offset, timeout_ns);
+        req->complete = [](IoRequest* r) {
+            auto* self = static_cast<CallbackRequest<Fn>*>(r);
+            self->fn(self->result);
+            delete self;
+        };
+        submit(req);
+    }
+
+    Awaiter makeAwaiter(IoOp op, int fd, void* buf, std::size_t len,
+                        int64_t offset, int64_t timeout_ns) {
+        Awaiter a;
+        fill(a, op, fd, buf, len, offset, timeout_ns);
+        a.reactor = this;
+        return a;
+    }
+
+    static void fill(IoRequest& r, IoOp op, int fd, void* buf, std::size_t len,
+                     int64_t offset, int64_t timeout_ns) {
+        r.op = op;
+        r.fd = fd;
+        r.buf = buf;
+        r.len = len;
+        r.offset = offset;
+        r.timeout_ns = timeout_ns;
+    }
+
+    void loop();
+    void deliver(IoRequest* request);
+
+    Scheduler&                      scheduler_;
+    Backend                         backend_kind_;
+    std::unique_ptr<ReactorBackend> backend_;
+    SeqRing<IoRequest*>             submissions_;
+    std::atomic<bool>               stopping_{false};
+    std::atomic<std::size_t>        outstanding_{0};
+    alignas(64) std::atomic<bool>   sleeping_{false};
+    std::thread                     thread_;
+};
+
+#endif
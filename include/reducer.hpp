@@ -0,0 +1,60 @@
+// reducer.hpp
+#ifndef REDUCER_HPP
+#define REDUCER_HPP
+
+#include "scheduler.hpp"
+
+#include <cassert>
+#include <functional>
+#include <vector>
+#include <cstddef>
+
+// Per-worker partial accumulator
+//
+// Each worker folds into its own cache-line padded slot, keyed by
+// Scheduler::workerIndex(), so tasks never contend on a shared atomic.
+// combine() merges the slots once, after the work feeding it has finished.
+// One extra slot serves the (single) thread outside the pool, e.g. the one
+// submitting the work. The slots are sized from the running pool, so build
+// the reducer after scheduler.start() and don't keep it across a restart.
+// Typed on the scheduler so the slot lookup inlines into add().
+template<typename T, typename Op = std::plus<T>, typename Sched = Scheduler>
+class Reducer {
+public:
+    explicit Reducer(const Sched& scheduler, T identity = T{}, Op op = Op{})
+        : scheduler_(&scheduler), identity_(identity), op_(op),
+          slots_(scheduler.workerCount() + 1, Slot{identity}) {
+        assert(scheduler.workerCount() > 0 && "build the Reducer after scheduler.start()");
+    }
+
+    T& local() {
+        std::size_t index = scheduler_->workerIndex();
+        assert(index < slots_.size() && "scheduler restarted with more workers");
+        return slots_[index].value;
+    }
+
+    void add(const T& value) {
+        T& slot = local();
+        slot = op_(slot, value);
+    }
+
+    T combine() const {
+        T total = identity_;
+        for (const Slot& slot : slots_) total = op_(total, slot.value);
+        return total;
+    }
+
+    void reset() {
+        for (Slot& slot : slots_) slot.value = identity_;
+    }
+
+private:
+    struct alignas(64) Slot { T value; };
+
+    const Sched*      scheduler_;
+    T                 identity_;
+    Op                op_;
+    std::vector<Slot> slots_;
+};
+
+#endif
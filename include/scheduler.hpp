@@ -5,8 +5,12 @@
 #include "lock_free_queue.hpp"
 #include <span>
 #include "concurrent_hash_map.hpp"
+#include "task_result.hpp"
+#include "scheduler_hooks.hpp"
 
 #include <queue>
+#include <deque>
+#include <string>
 #include <mutex>
 #include <condition_variable> 
 #include <thread>
@@ -17,61 +21,507 @@
 #include <functional> 
 #include <algorithm> 
 #include <cassert> 
+#include <memory>
+#include <chrono>
+#include <type_traits>
+#include <tuple>
+#include <array>
 
-class Scheduler {
+// Handle to a named resource class, see Scheduler::addResourceClass()
+struct ResourceClass {
+    uint32_t index = 0;     // 0 = unconstrained
+};
+
+// Bounds and thresholds for Scheduler::start(const ElasticConfig&)
+struct ElasticConfig {
+    std::size_t minWorkers = 1;
+    std::size_t maxWorkers = 0;                     // 0 = hardware_concurrency
+    std::chrono::microseconds sampleInterval{1000};
+    // A worker is added once the pool has looked overloaded for this many
+    // consecutive samples with nobody parked
+    std::size_t sustainedSamples = 3;
+    std::size_t depthPerWorker = 64;                // queued events per worker
+    std::chrono::microseconds maxQueueWait{2000};   // depth / completion rate
+    // Parked workers above minWorkers exit after this long without work
+    std::chrono::milliseconds retireAfter{200};
+};
+
+// Completion of one scheduleBulk() call. Works with or without an id, e.g.
+// scheduler.waitFor(scheduler.scheduleBulk(DETACHED_ID, 0, n, fn)).
+class BulkHandle {
+    public:
+        BulkHandle() = default;
+
+        bool done() const {
+            return !remaining_ || remaining_->count.load(std::memory_order_acquire) == 0;
+        }
+        bool operator()() const { return done(); }
+
+    private:
+        template<typename> friend class BasicScheduler;
+
+        struct alignas(64) Remaining {
+            explicit Remaining(std::size_t n) : count(n) {}
+            std::atomic<std::size_t> count;
+        };
+
+        explicit BulkHandle(std::shared_ptr<Remaining> remaining)
+            : remaining_(std::move(remaining)) {}
+
+        std::shared_ptr<Remaining> remaining_;
+};
+
+struct SchedulerStats {
+    std::size_t minWorkers = 0;
+    std::size_t maxWorkers = 0;
+    std::size_t activeWorkers = 0;
+    std::size_t parkedWorkers = 0;
+    std::size_t peakWorkers = 0;
+    std::size_t queueDepth = 0;
+    uint64_t scaleUps = 0;          // workers added by the controller
+    uint64_t scaleDowns = 0;        // workers retired after parking
+    std::size_t tasksSubmitted = 0;
+    std::size_t tasksCompleted = 0;
+};
+
+// Which scheduler (and which of its workers) owns the calling thread, so
+// work submitted from inside an event stays on that worker's deque.
+namespace scheduler_detail {
+inline thread_local const void* tls_scheduler = nullptr;
+inline thread_local std::size_t tls_worker    = 0;
+}
+
+template<typename Hooks>
+class BasicScheduler;
+
+// Handed to tasks scheduled by id whose function takes it, so a running
+// task can grow the graph around itself.
+template<typename Hooks>
+class BasicDependencyContext {
+    public:
+        BasicDependencyContext(BasicScheduler<Hooks>* sched, uint64_t id) noexcept;
+
+        uint64_t id() const { return current_task_id_; }
+
+        // target_task_id won't run before the current task has finished
+        bool addDependency(uint64_t target_task_id) const;
+
+        // Schedules a new task by id; list id() in deps to make it a
+        // continuation of the current task.
+        template<typename Fn>
+        void spawn(uint64_t id, Fn&& fn, std::span<const uint64_t> deps = {}) const;
+
+    private:
+        BasicScheduler<Hooks>* scheduler_;
+        uint64_t current_task_id_;
+};
+
+// Hooks are compiled in, see scheduler_hooks.hpp. Everything else names
+// the Scheduler alias below.
+template<typename Hooks>
+class BasicScheduler {
     public: 
-        Scheduler();
-        ~Scheduler();
+        // Events carrying this id skip the dependency maps entirely: they
+        // can't be waited on by id and never notify subscribers.
+        static constexpr uint64_t DETACHED_ID = ~uint64_t{0};
+
+        using DependencyContext = BasicDependencyContext<Hooks>;
+
+        BasicScheduler();
+        ~BasicScheduler();
+
+        BasicScheduler(const BasicScheduler&) = delete;
+        BasicScheduler& operator=(const BasicScheduler&) = delete;
+
+        Hooks& hooks() { return hooks_; }
         void scheduleEvent(Event event);
+        // Prefers the worker std::hash(affinity) maps to, so events sharing
+        // a key reuse that worker's cache. Others steal it only when idle.
+        void scheduleEvent(Event event, uint64_t affinity);
+        // Runs the event while holding one of the class's tokens. The token
+        // is taken at dispatch, when a worker picks the event up, so none is
+        // held while it waits in a queue. Without a free token the event is
+        // parked in the class's queue, not on a worker, and handed the token
+        // of the next holder that finishes.
+        void scheduleEvent(Event event, ResourceClass resource);
+
+        // At most `tokens` events of the class run at once. Register classes
+        // before scheduling against them; the table isn't grown concurrently.
+        ResourceClass addResourceClass(const std::string& name, std::size_t tokens);
+        ResourceClass findResourceClass(const std::string& name) const;
         void start();
+        // Elastic mode: starts minWorkers threads and lets a controller add
+        // more, up to maxWorkers, while queue depth or the estimated queue
+        // wait stays high. Workers that stay idle park and eventually retire
+        // back down to minWorkers; a worker only retires with nothing queued
+        // locally, so in-flight work is never moved or dropped.
+        void start(const ElasticConfig& config);
         void stop();
+        SchedulerStats stats() const;
         void markDone();
+        // Blocks an external thread until all submitted work has finished.
+        // From inside an event use waitFor(), this count includes the caller.
+        // I/O in flight on a Reactor isn't work yet, see Reactor::outstanding().
         void waitUntilFinished();
-        //void addDependency(uint64_t from_task_id, uint64_t target_task_id);
 
+        // Makes target_task_id wait for from_task_id as well. Safe while
+        // either task runs: the target must not have been released yet
+        // (not scheduled, or still waiting on another parent). Returns true
+        // if the edge is pending, false if from_task_id had already finished
+        // (the edge is satisfied on the spot) or the target was released.
+        bool addDependency(uint64_t from_task_id, uint64_t target_task_id);
+        bool isFinished(uint64_t id);
+        // Drops a finished id's completion record, so a dependent scheduled
+        // later waits for its next run instead of counting the old one as
+        // done. Returns false, keeping the record, if the id hasn't finished.
+        // Nothing may schedule against or query the id while this runs.
+        bool forget(uint64_t id);
+
+        // Runs user_fn once every id in deps has finished. A dep that
+        // already finished counts as satisfied; one that was never scheduled
+        // is waited for. user_fn may take a DependencyContext&.
+        //
+        // Reusing ids: a dep binds to the run of the id that is current when
+        // the dependent is scheduled. Once a run finished it stays current
+        // until the id is scheduled again (allowed only after it finished)
+        // or forget() drops it. So schedule a rerun before its dependents,
+        // or forget() the id first; otherwise they see the finished run and
+        // start at once.
         template<typename Fn>
         void scheduleEvent(uint64_t id, 
             Fn&& user_fn, std::span<const uint64_t> deps);
 
+        // Typed task: runs user_fn(parents.get()...) once every parent has
+        // finished and stores what it returns in the handle's slot. Parent
+        // values are passed by const reference, never copied, and the task
+        // lets go of them right after it ran. Don't reschedule a parent's id
+        // while a consumer of its handle is still waiting.
+        template<typename Fn, typename... Ps>
+        auto scheduleEvent(uint64_t id, Fn&& user_fn, const TaskResult<Ps>&... parents)
+            -> TaskResult<std::decay_t<std::invoke_result_t<Fn&, const Ps&...>>>;
+
+        // One queue entry standing for fn(i) over [begin, end). Workers claim
+        // grain-sized sub-ranges through an atomic cursor and a helper is
+        // forked each time one is picked up (up to one per worker), so a
+        // million items cost a handful of queue operations. Completes as a
+        // unit: subscribers of id are released after the last index ran,
+        // and the returned handle reports done() from then on.
+        template<typename Fn>
+        BulkHandle scheduleBulk(uint64_t id, std::size_t begin, std::size_t end,
+                          Fn&& fn, std::size_t grain = 0);
+
+        // Worker slots, fixed for the scheduler's lifetime (in elastic mode
+        // this is maxWorkers, not the number of threads currently running)
+        std::size_t workerCount() const { return workerState.size(); }
+
+        // Index of the calling worker in [0, workerCount()), or
+        // workerCount() itself for any thread that is not one of ours.
+        std::size_t workerIndex() const;
+
+        // Waits until done() holds. On a worker thread the caller keeps
+        // running other ready events instead of parking, so nested
+        // fork/join never starves the pool.
+        template<typename Pred>
+        void waitFor(Pred&& done);
+
     private:
-        void run();
+        static constexpr std::size_t LOCAL_QUEUE_CAPACITY = 4096;
+        static constexpr std::size_t INBOX_CAPACITY = 1024;
+        // Empty polls before an elastic worker parks, and its nap length
+        static constexpr std::size_t IDLE_SPINS = 256;
+        static constexpr std::chrono::microseconds PARK_SLEEP{100};
+
+        enum class WorkerState : uint8_t { Inactive, Running, Parked };
+
+        struct alignas(64) Worker {
+            Worker(std::size_t capacity, std::size_t inbox_capacity)
+                : deque(capacity), inbox(inbox_capacity) {}
+            WorkStealingDeque<Event> deque;
+            // Affinity-tagged events, pushed by anyone, preferred by owner
+            SeqRing<Event> inbox;
+            // Unexecuted rest of the batch run() is draining, handed back
+            // to the deque if one of its events starts a helping wait.
+            Event* batchCur = nullptr;
+            Event* batchEnd = nullptr;
+            std::atomic<WorkerState> state{WorkerState::Inactive};
+            // Owner only
+            std::size_t idleRounds = 0;
+            std::chrono::steady_clock::time_point parkedSince;
+            // Events this worker submitted / ran. Only the owner writes, so
+            // counting is a plain store to an uncontended line.
+            alignas(64) std::atomic<uint64_t> submitted{0};
+            std::atomic<uint64_t> completed{0};
+        };
+
+        // Monotonic totals over every worker slot plus outside threads
+        struct WorkCounts {
+            uint64_t submitted = 0;
+            uint64_t completed = 0;
+            bool operator==(const WorkCounts&) const = default;
+        };
+
+        template<typename Fn>
+        struct BulkState;
+
+        // Completion state of one id. pending counts unfinished parents
+        // plus one guard held until scheduleEvent() has wired every dep,
+        // so a node can't be released half-built. Subscribers form a
+        // lock-free stack that the finishing task swaps for CLOSED: an edge
+        // whose push finds CLOSED knows its parent is done. fn is let go of
+        // as soon as it ran, so a finished node keeps no captured state.
+        struct TaskNode {
+            struct Link {
+                TaskNode* child;
+                Link* next;
+            };
+            static Link* closed() { return reinterpret_cast<Link*>(uintptr_t{1}); }
+
+            explicit TaskNode(uint64_t task_id) : id(task_id) {}
+            // Only a node that never finished still has links to free
+            ~TaskNode() {
+                Link* link = subscribers.load(std::memory_order_relaxed);
+                while (link != nullptr && link != closed()) {
+                    Link* next = link->next;
+                    delete link;
+                    link = next;
+                }
+            }
+            bool finished() const {
+                return subscribers.load(std::memory_order_acquire) == closed();
+            }
+
+            const uint64_t id;
+            std::atomic<int64_t> pending{1};
+            std::atomic<Link*> subscribers{nullptr};
+            std::function<void()> fn;
+        };
+
+        struct ResourcePool {
+            ResourcePool(const std::string& n, std::size_t t)
+                : name(n), tokens(static_cast<int64_t>(t)) {}
+            std::string name;
+            alignas(64) std::atomic<int64_t> tokens;
+            std::mutex waitingLock;
+            std::deque<Event> waiting;
+        };
+
+        bool tryAcquireToken(ResourcePool& pool);
+        void releaseToken(uint32_t resource);
+
+        void startWorkers(std::size_t slots, std::size_t initial);
+        void activateWorker(std::size_t index);
+        void controller();
+        std::size_t queueDepth() const;
+        void markBusy(Worker& self);
+        bool idle(Worker& self);
+        void run(std::size_t index);
         void alternate_run();
-        void executeEvent(Event& task);
+        bool executeEvent(Event& task, std::size_t worker);
+        bool acquireTokenFor(Event& event);
+        void countSubmitted(const Event& event);
+        void countCompleted(Worker& self, std::size_t n);
+        WorkCounts collectCounts() const;
+        uint64_t outstandingWork() const;
         void notifyFinished(uint64_t finished_id);        
-        void ensureTaskRow(uint64_t id);
+        TaskNode& taskNode(uint64_t id);
+        TaskNode& beginTask(uint64_t id);
+        bool addEdge(TaskNode& parent, TaskNode& child);
+        void releaseEdge(TaskNode& child);
+        void enqueue(Event&& event);
+        bool currentWorker(std::size_t& index) const;
+        bool runOne(std::size_t index);
+        std::optional<Event> steal(std::size_t index);
+        void spillBatch(std::size_t index);
 
         std::atomic<bool> running;
         std::atomic<bool> doneSubmitting;
-        std::atomic<size_t> tasksSubmitted{0};
-        std::atomic<size_t> tasksCompleted{0};
+        // Counts of threads outside the pool, and of slots torn down by stop()
+        alignas(64) std::atomic<uint64_t> externalSubmitted{0};
+        std::atomic<uint64_t> externalCompleted{0};
+        std::atomic<uint64_t> stoppedSubmitted{0};
+        std::atomic<uint64_t> stoppedCompleted{0};
         SeqRing<Event> event_queue;
         std::vector<std::thread> workers;
+        std::vector<std::unique_ptr<Worker>> workerState;
+
+        bool elastic = false;
+        ElasticConfig elasticConfig;
+        std::thread controllerThread;
+        std::atomic<std::size_t> activeWorkers{0};
+        std::atomic<std::size_t> parkedWorkers{0};
+        std::atomic<std::size_t> peakWorkers{0};
+        std::atomic<uint64_t> scaleUps{0};
+        std::atomic<uint64_t> scaleDowns{0};
+        std::vector<std::unique_ptr<ResourcePool>> resources;
         
-        ConcurrentHashMap<uint64_t, std::mutex> taskLocks;
-        ConcurrentHashMap<uint64_t, std::vector<uint64_t>> subscribers;
-        ConcurrentHashMap<uint64_t, std::size_t> dependencyCount;
-        ConcurrentHashMap<uint64_t, std::function<void()>> functionCalls;
+        ConcurrentHashMap<uint64_t, TaskNode> taskNodes;
+        [[no_unique_address]] Hooks hooks_;
     };
+template<typename Hooks>
 template<typename Fn>
-void Scheduler::scheduleEvent(uint64_t id, Fn&& user_fn, std::span<const uint64_t> deps) {
-    ensureTaskRow(id);
-    {
-        std::mutex* mtx = taskLocks.find(id);
-        std::lock_guard guard(*mtx);
-
-        functionCalls.insert_or_assign(id, std::forward<Fn>(user_fn));
+void BasicScheduler<Hooks>::scheduleEvent(uint64_t id, Fn&& user_fn, std::span<const uint64_t> deps) {
+    TaskNode& node = taskNode(id);
+    // Reopen a finished node; a fresh one is already open with its guard
+    typename TaskNode::Link* closed = TaskNode::closed();
+    if (node.subscribers.compare_exchange_strong(closed, nullptr, std::memory_order_acq_rel)) {
+        node.pending.store(1, std::memory_order_relaxed);
+    }
+    if constexpr (std::is_invocable_v<Fn&, DependencyContext&>) {
+        node.fn = [this, id, f = std::forward<Fn>(user_fn)]() mutable {
+            DependencyContext ctx(this, id);
+            f(ctx);
+        };
+    } else {
+        node.fn = std::forward<Fn>(user_fn);
     }
-    dependencyCount.insert_or_assign(id, deps.size());
     for (uint64_t parent : deps) {
-        ensureTaskRow(parent);
-        subscribers.find(parent)->push_back(id);
+        TaskNode& p = taskNode(parent);
+        node.pending.fetch_add(1, std::memory_order_relaxed);
+        if (!addEdge(p, node))
+            node.pending.fetch_sub(1, std::memory_order_relaxed);
+    }
+    releaseEdge(node);
+}
+
+template<typename Hooks>
+template<typename Fn, typename... Ps>
+auto BasicScheduler<Hooks>::scheduleEvent(uint64_t id, Fn&& user_fn, const TaskResult<Ps>&... parents)
+    -> TaskResult<std::decay_t<std::invoke_result_t<Fn&, const Ps&...>>> {
+    using R = std::decay_t<std::invoke_result_t<Fn&, const Ps&...>>;
+    static_assert(!std::is_void_v<R>,
+                  "typed tasks return a value, use the deps overload otherwise");
+
+    TaskResult<R> result(id);
+    const std::array<uint64_t, sizeof...(Ps)> deps{parents.id()...};
+    scheduleEvent(id,
+        [out = result, in = std::make_tuple(parents...),
+         f = std::forward<Fn>(user_fn)]() mutable {
+            out.publish(std::apply([&f](const TaskResult<Ps>&... p) {
+                return f(p.get()...);
+            }, in));
+            // Last consumer out frees the parents' values
+            in = {};
+            out.release();
+        },
+        std::span<const uint64_t>(deps));
+    return result;
+}
+
+template<typename Hooks>
+template<typename Fn>
+void BasicDependencyContext<Hooks>::spawn(uint64_t id, Fn&& fn, std::span<const uint64_t> deps) const {
+    scheduler_->scheduleEvent(id, std::forward<Fn>(fn), deps);
+}
+
+template<typename Hooks>
+template<typename Fn>
+struct BasicScheduler<Hooks>::BulkState {
+    BulkState(BasicScheduler* s, uint64_t task_id, std::size_t begin,
+              std::size_t last, Fn&& f, std::size_t g, unsigned max_runners)
+        : sched(s), id(task_id), fn(std::forward<Fn>(f)), end(last),
+          grain(g), maxRunners(max_runners), cursor(begin),
+          unfinished(std::make_shared<BulkHandle::Remaining>(last - begin)) {}
+
+    void spawn() {
+        refs.fetch_add(1, std::memory_order_relaxed);
+        Event runner(DETACHED_ID, [this]() { runChunks(); });
+        sched->countSubmitted(runner);
+        sched->enqueue(std::move(runner));
+    }
+
+    void runChunks() {
+        // Whoever picks the range up forks the next helper, so the fan-out
+        // only grows as fast as workers actually become free for it
+        std::size_t next = cursor.load(std::memory_order_relaxed);
+        if (next < end && end - next > grain) {
+            unsigned r = runners.load(std::memory_order_relaxed);
+            if (r < maxRunners &&
+                runners.compare_exchange_strong(r, r + 1, std::memory_order_relaxed))
+                spawn();
+        }
+
+        // Claims never move the cursor past end, so a range ending near
+        // SIZE_MAX can't wrap it back into already claimed indices
+        std::size_t lo = cursor.load(std::memory_order_relaxed);
+        while (lo < end) {
+            std::size_t hi = lo + std::min(grain, end - lo);
+            if (!cursor.compare_exchange_weak(lo, hi, std::memory_order_relaxed))
+                continue;
+            for (std::size_t i = lo; i < hi; ++i) fn(i);
+            if (unfinished->count.fetch_sub(hi - lo, std::memory_order_acq_rel) == hi - lo &&
+                id != DETACHED_ID)
+                sched->notifyFinished(id);
+            lo = cursor.load(std::memory_order_relaxed);
+        }
+
+        if (refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            delete this;
+    }
+
+    BasicScheduler*     sched;
+    uint64_t            id;
+    std::decay_t<Fn>    fn;
+    std::size_t         end;
+    std::size_t         grain;
+    unsigned            maxRunners;
+    std::atomic<unsigned> runners{1};
+    std::atomic<unsigned> refs{0};
+    alignas(64) std::atomic<std::size_t> cursor;
+    std::shared_ptr<BulkHandle::Remaining> unfinished;
+};
+
+template<typename Hooks>
+template<typename Fn>
+BulkHandle BasicScheduler<Hooks>::scheduleBulk(uint64_t id, std::size_t begin, std::size_t end,
+                             Fn&& fn, std::size_t grain) {
+    if (id != DETACHED_ID)
+        beginTask(id);
+    if (begin >= end) {
+        if (id != DETACHED_ID) notifyFinished(id);
+        return BulkHandle();
     }
-    if (deps.size() == 0) {
-        Event event{id,
-            [this, id]() { (*functionCalls.find(id))(); }};
+    std::size_t workers = std::max<std::size_t>(1, workerCount());
+    if (grain == 0)
+        grain = std::max<std::size_t>(1, (end - begin) / (workers * 8));
 
-        tasksSubmitted.fetch_add(1, std::memory_order_relaxed);
-        event_queue.push(std::move(event));
+    auto* state = new BulkState<Fn>(this, id, begin, end, std::forward<Fn>(fn),
+                                    grain, static_cast<unsigned>(workers));
+    BulkHandle handle(state->unfinished);
+    state->spawn();
+    return handle;
+}
+
+template<typename Hooks>
+template<typename Pred>
+void BasicScheduler<Hooks>::waitFor(Pred&& done) {
+    std::size_t index;
+    if (!currentWorker(index)) {
+        while (!done() && running)
+            std::this_thread::sleep_for(std::chrono::microseconds(5));
+        return;
+    }
+    spillBatch(index);
+    while (!done() && running) {
+        if (!runOne(index))
+            std::this_thread::yield();
     }
 }
-#endif
\ No newline at end of file
+
+#include "scheduler.tpp"
+
+// scripts/build -t compiles the default scheduler with telemetry hooks
+#ifdef TELEMETRY_ENABLED
+using SchedulerHooks = TelemetryHooks;
+#else
+using SchedulerHooks = NoHooks;
+#endif
+
+using Scheduler = BasicScheduler<SchedulerHooks>;
+using DependencyContext = BasicDependencyContext<SchedulerHooks>;
+
+// Built once in scheduler.cpp
+extern template class BasicScheduler<NoHooks>;
+extern template class BasicScheduler<TelemetryHooks>;
+extern template class BasicDependencyContext<NoHooks>;
+extern template class BasicDependencyContext<TelemetryHooks>;
+#endif
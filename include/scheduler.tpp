@@ -0,0 +1,617 @@
+// scheduler.tpp
+#ifndef SCHEDULER_TPP
+#define SCHEDULER_TPP
+
+#include "scheduler.hpp"
+
+template<typename Hooks>
+BasicScheduler<Hooks>::BasicScheduler() : running(false), doneSubmitting(false), event_queue(1024 * 1024) {}
+
+template<typename Hooks>
+BasicScheduler<Hooks>::~BasicScheduler() {
+    stop();
+}
+template<typename Hooks>
+void BasicScheduler<Hooks>::start() {
+    size_t thread_count = std::thread::hardware_concurrency();
+    //thread_count = 4;
+    if (thread_count == 0) thread_count = 4;
+    elastic = false;
+    startWorkers(thread_count, thread_count);
+}
+
+template<typename Hooks>
+void BasicScheduler<Hooks>::start(const ElasticConfig& config) {
+    elasticConfig = config;
+    if (elasticConfig.maxWorkers == 0)
+        elasticConfig.maxWorkers = std::max(1u, std::thread::hardware_concurrency());
+    elasticConfig.minWorkers = std::clamp<std::size_t>(elasticConfig.minWorkers, 1,
+                                                       elasticConfig.maxWorkers);
+    elastic = true;
+    startWorkers(elasticConfig.maxWorkers, elasticConfig.minWorkers);
+    controllerThread = std::thread(&BasicScheduler::controller, this);
+}
+
+// All slots exist up front so indices, inboxes and per-worker reducers stay
+// valid while threads come and go; only `initial` of them get a thread.
+template<typename Hooks>
+void BasicScheduler<Hooks>::startWorkers(std::size_t slots, std::size_t initial) {
+    running = true;
+    doneSubmitting = false;
+    scaleUps = 0;
+    scaleDowns = 0;
+    peakWorkers = 0;
+    event_queue.setWorkerCount(slots);
+    hooks_.on_workers(0, slots);
+    for (size_t i = 0; i < slots; ++i) {
+        workerState.push_back(std::make_unique<Worker>(LOCAL_QUEUE_CAPACITY, INBOX_CAPACITY));
+    }
+    workers.resize(slots);
+    for (size_t i = 0; i < initial; ++i) {
+        activateWorker(i);
+    }
+    hooks_.on_workers(initial, slots);
+}
+
+// Only called by start() and the controller, so the thread objects are
+// never touched concurrently. A retired slot's thread has already left
+// run() or is about to, joining it here is quick.
+template<typename Hooks>
+void BasicScheduler<Hooks>::activateWorker(std::size_t index) {
+    if (workers[index].joinable())
+        workers[index].join();
+    Worker& w = *workerState[index];
+    w.idleRounds = 0;
+    w.state.store(WorkerState::Running, std::memory_order_release);
+    std::size_t active = activeWorkers.fetch_add(1, std::memory_order_acq_rel) + 1;
+    std::size_t peak = peakWorkers.load(std::memory_order_relaxed);
+    while (active > peak &&
+           !peakWorkers.compare_exchange_weak(peak, active, std::memory_order_relaxed)) {}
+    workers[index] = std::thread(&BasicScheduler::run, this, index);
+}
+
+// Stop the scheduler and join all threads
+template<typename Hooks>
+void BasicScheduler<Hooks>::stop() {
+    if(!running) 
+        return;
+    running = false;
+    if (controllerThread.joinable())
+        controllerThread.join();
+    for (std::thread& t : workers) {
+        if (t.joinable()) {
+            t.join();
+        }
+    }
+
+    // Work still queued on a slot outlives it in the shared ring, where the
+    // next start() picks it up. Should the ring be full, with nobody left
+    // to drain it, the event runs right here instead.
+    for (const auto& w : workerState) {
+        std::optional<Event> ev;
+        while ((ev = w->deque.pop()) || (ev = w->inbox.pop())) {
+            if (!event_queue.tryPush(std::move(*ev)) && executeEvent(*ev, workerState.size()))
+                externalCompleted.fetch_add(1, std::memory_order_release);
+        }
+    }
+
+    // Keep the totals monotonic across a restart
+    for (const auto& w : workerState) {
+        stoppedSubmitted.fetch_add(w->submitted.load(std::memory_order_relaxed),
+                                   std::memory_order_relaxed);
+        stoppedCompleted.fetch_add(w->completed.load(std::memory_order_relaxed),
+                                   std::memory_order_relaxed);
+    }
+    hooks_.on_workers(0, workerState.size());
+    workers.clear();
+    workerState.clear();
+    activeWorkers = 0;
+    parkedWorkers = 0;
+}
+
+template<typename Hooks>
+std::size_t BasicScheduler<Hooks>::queueDepth() const {
+    std::size_t depth = event_queue.sizeApprox();
+    for (const auto& w : workerState)
+        depth += w->deque.sizeApprox() + w->inbox.sizeApprox();
+    return depth;
+}
+
+template<typename Hooks>
+SchedulerStats BasicScheduler<Hooks>::stats() const {
+    SchedulerStats s;
+    s.minWorkers     = elastic ? elasticConfig.minWorkers : workerState.size();
+    s.maxWorkers     = workerState.size();
+    s.activeWorkers  = activeWorkers.load(std::memory_order_relaxed);
+    s.parkedWorkers  = parkedWorkers.load(std::memory_order_relaxed);
+    s.peakWorkers    = peakWorkers.load(std::memory_order_relaxed);
+    s.queueDepth     = queueDepth();
+    s.scaleUps       = scaleUps.load(std::memory_order_relaxed);
+    s.scaleDowns     = scaleDowns.load(std::memory_order_relaxed);
+    WorkCounts counts = collectCounts();
+    s.tasksSubmitted = counts.submitted;
+    s.tasksCompleted = counts.completed;
+    return s;
+}
+
+// Elastic mode only. Samples the backlog every sampleInterval; the pool is
+// overloaded when nobody is parked and either the backlog per running
+// worker or the wait it implies at the current completion rate (Little's
+// law) is above its threshold. Growth needs that to hold for
+// sustainedSamples in a row, so a single burst doesn't spawn a thread.
+// Shrinking is left to the workers themselves, see idle().
+template<typename Hooks>
+void BasicScheduler<Hooks>::controller() {
+    const ElasticConfig& cfg = elasticConfig;
+    uint64_t lastCompleted = collectCounts().completed;
+    std::size_t overloaded = 0;
+    while (running.load(std::memory_order_relaxed)) {
+        std::this_thread::sleep_for(cfg.sampleInterval);
+
+        uint64_t completed = collectCounts().completed;
+        uint64_t throughput = completed - lastCompleted;
+        lastCompleted = completed;
+
+        std::size_t active = activeWorkers.load(std::memory_order_acquire);
+        std::size_t depth = queueDepth();
+        bool high = false;
+        if (depth > 0 && parkedWorkers.load(std::memory_order_relaxed) == 0) {
+            auto wait = throughput == 0
+                ? std::chrono::microseconds::max()
+                : std::chrono::microseconds(cfg.sampleInterval.count() * depth / throughput);
+            high = depth > active * cfg.depthPerWorker || wait > cfg.maxQueueWait;
+        }
+        overloaded = high ? overloaded + 1 : 0;
+        if (overloaded < cfg.sustainedSamples || active >= cfg.maxWorkers)
+            continue;
+
+        overloaded = 0;
+        for (std::size_t i = 0; i < workerState.size(); ++i) {
+            if (workerState[i]->state.load(std::memory_order_acquire) != WorkerState::Inactive)
+                continue;
+            activateWorker(i);
+            scaleUps.fetch_add(1, std::memory_order_relaxed);
+            hooks_.on_workers(active + 1, workerState.size());
+            break;
+        }
+    }
+}
+
+template<typename Hooks>
+void BasicScheduler<Hooks>::scheduleEvent(Event event) {
+    if (event.getId() != DETACHED_ID)
+        beginTask(event.getId());
+    countSubmitted(event);
+    enqueue(std::move(event));
+}
+
+template<typename Hooks>
+void BasicScheduler<Hooks>::scheduleEvent(Event event, uint64_t affinity) {
+    if (event.getId() != DETACHED_ID)
+        beginTask(event.getId());
+    countSubmitted(event);
+    if (workerState.empty()) {
+        enqueue(std::move(event));
+        return;
+    }
+
+    std::size_t preferred = std::hash<uint64_t>{}(affinity) % workerState.size();
+    if ((scheduler_detail::tls_scheduler == this && scheduler_detail::tls_worker == preferred) ||
+        workerState[preferred]->state.load(std::memory_order_relaxed) == WorkerState::Inactive) {
+        enqueue(std::move(event));
+        return;
+    }
+    if (!workerState[preferred]->inbox.tryPush(std::move(event)))
+        enqueue(std::move(event));
+}
+
+template<typename Hooks>
+ResourceClass BasicScheduler<Hooks>::addResourceClass(const std::string& name, std::size_t tokens) {
+    assert(tokens > 0 && "a resource class needs at least one token");
+    resources.push_back(std::make_unique<ResourcePool>(name, tokens));
+    return ResourceClass{static_cast<uint32_t>(resources.size())};
+}
+
+template<typename Hooks>
+ResourceClass BasicScheduler<Hooks>::findResourceClass(const std::string& name) const {
+    for (std::size_t i = 0; i < resources.size(); ++i) {
+        if (resources[i]->name == name)
+            return ResourceClass{static_cast<uint32_t>(i + 1)};
+    }
+    return ResourceClass{};
+}
+
+template<typename Hooks>
+void BasicScheduler<Hooks>::scheduleEvent(Event event, ResourceClass resource) {
+    if (resource.index == 0) {
+        scheduleEvent(std::move(event));
+        return;
+    }
+    if (event.getId() != DETACHED_ID)
+        beginTask(event.getId());
+    countSubmitted(event);
+    event.setResourceClass(resource.index);
+    enqueue(std::move(event));
+}
+
+// At dispatch: true if the event may run now. Otherwise it was moved into
+// the class's queue and runs once releaseToken() hands it a token.
+template<typename Hooks>
+bool BasicScheduler<Hooks>::acquireTokenFor(Event& event) {
+    ResourcePool& pool = *resources[event.getResourceClass() - 1];
+    if (!tryAcquireToken(pool)) {
+        // Re-check under the lock, releaseToken() hands tokens to parked
+        // events under the same lock, so nothing can be left stranded
+        std::lock_guard lg(pool.waitingLock);
+        if (!tryAcquireToken(pool)) {
+            pool.waiting.push_back(std::move(event));
+            return false;
+        }
+    }
+    event.setHoldsToken(true);
+    return true;
+}
+
+template<typename Hooks>
+bool BasicScheduler<Hooks>::tryAcquireToken(ResourcePool& pool) {
+    int64_t t = pool.tokens.load(std::memory_order_relaxed);
+    while (t > 0) {
+        if (pool.tokens.compare_exchange_weak(t, t - 1,
+                std::memory_order_acquire, std::memory_order_relaxed))
+            return true;
+    }
+    return false;
+}
+
+// The finishing event's token goes straight to the oldest parked event
+template<typename Hooks>
+void BasicScheduler<Hooks>::releaseToken(uint32_t resource) {
+    ResourcePool& pool = *resources[resource - 1];
+    std::optional<Event> next;
+    {
+        std::lock_guard lg(pool.waitingLock);
+        if (pool.waiting.empty()) {
+            pool.tokens.fetch_add(1, std::memory_order_release);
+            return;
+        }
+        next.emplace(std::move(pool.waiting.front()));
+        pool.waiting.pop_front();
+    }
+    next->setHoldsToken(true);
+    enqueue(std::move(*next));
+}
+
+template<typename Hooks>
+void BasicScheduler<Hooks>::markDone() {
+    doneSubmitting.store(true);
+}
+
+// Events submitted from one of our workers go LIFO onto its own deque,
+// everything else (and deque overflow) goes through the shared ring.
+template<typename Hooks>
+void BasicScheduler<Hooks>::enqueue(Event&& event) {
+    if (scheduler_detail::tls_scheduler == this &&
+        workerState[scheduler_detail::tls_worker]->deque.push(std::move(event)))
+        return;
+    event_queue.push(std::move(event));
+}
+
+// Inline so callers outside the explicit instantiations (Reducer::add)
+// still get them inlined despite the extern template declarations
+template<typename Hooks>
+inline bool BasicScheduler<Hooks>::currentWorker(std::size_t& index) const {
+    if (scheduler_detail::tls_scheduler != this) return false;
+    index = scheduler_detail::tls_worker;
+    return true;
+}
+
+template<typename Hooks>
+inline std::size_t BasicScheduler<Hooks>::workerIndex() const {
+    std::size_t index;
+    return currentWorker(index) ? index : workerState.size();
+}
+
+// Other workers' deques first, their affinity inboxes only as a last resort
+template<typename Hooks>
+std::optional<Event> BasicScheduler<Hooks>::steal(std::size_t index) {
+    const std::size_t n = workerState.size();
+    for (std::size_t i = 1; i < n; ++i) {
+        if (std::optional<Event> ev = workerState[(index + i) % n]->deque.steal())
+            return ev;
+    }
+    for (std::size_t i = 1; i < n; ++i) {
+        if (std::optional<Event> ev = workerState[(index + i) % n]->inbox.pop())
+            return ev;
+    }
+    return std::nullopt;
+}
+
+// Runs a single ready event: own deque, own inbox, the shared ring, then
+// whatever can be stolen. Returns false if nothing was runnable.
+template<typename Hooks>
+bool BasicScheduler<Hooks>::runOne(std::size_t index) {
+    Worker& self = *workerState[index];
+    std::optional<Event> ev = self.deque.pop();
+    if (!ev) ev = self.inbox.pop();
+    if (!ev) ev = event_queue.pop();
+    if (!ev) ev = steal(index);
+    if (!ev) return false;
+
+    if (executeEvent(*ev, index))
+        countCompleted(self, 1);
+    return true;
+}
+
+// A helping wait may block on anything still sitting in the batch buffer
+// on our stack, so hand those back where other workers can reach them.
+template<typename Hooks>
+void BasicScheduler<Hooks>::spillBatch(std::size_t index) {
+    Worker& self = *workerState[index];
+    while (self.batchCur != self.batchEnd) {
+        Event& ev = *self.batchCur++;
+        if (!self.deque.push(std::move(ev)))
+            event_queue.push(std::move(ev));
+    }
+}
+
+template<typename Hooks>
+void BasicScheduler<Hooks>::markBusy(Worker& self) {
+    self.idleRounds = 0;
+    if (self.state.load(std::memory_order_relaxed) == WorkerState::Parked) {
+        self.state.store(WorkerState::Running, std::memory_order_relaxed);
+        parkedWorkers.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+// Called after a round that found nothing to run. A fixed pool just yields.
+// An elastic worker parks after IDLE_SPINS empty rounds, napping between
+// polls, and retires once it has been parked for retireAfter unless that
+// would take the pool below minWorkers. Returns false if it retired.
+template<typename Hooks>
+bool BasicScheduler<Hooks>::idle(Worker& self) {
+    if (!elastic || ++self.idleRounds < IDLE_SPINS) {
+        std::this_thread::yield();
+        return true;
+    }
+    auto now = std::chrono::steady_clock::now();
+    if (self.state.load(std::memory_order_relaxed) != WorkerState::Parked) {
+        self.state.store(WorkerState::Parked, std::memory_order_relaxed);
+        self.parkedSince = now;
+        parkedWorkers.fetch_add(1, std::memory_order_relaxed);
+    } else if (now - self.parkedSince >= elasticConfig.retireAfter &&
+               self.deque.sizeApprox() == 0 && self.inbox.sizeApprox() == 0) {
+        std::size_t active = activeWorkers.load(std::memory_order_relaxed);
+        while (active > elasticConfig.minWorkers) {
+            if (activeWorkers.compare_exchange_weak(active, active - 1,
+                    std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                // Affinity events that slipped into the inbox since the
+                // check go to the shared ring; anything pushed after the
+                // drain is picked up by the other workers' steal() scan
+                parkedWorkers.fetch_sub(1, std::memory_order_relaxed);
+                self.state.store(WorkerState::Inactive, std::memory_order_release);
+                while (std::optional<Event> ev = self.inbox.pop())
+                    event_queue.push(std::move(*ev));
+                scaleDowns.fetch_add(1, std::memory_order_relaxed);
+                hooks_.on_workers(active - 1, workerState.size());
+                return false;
+            }
+        }
+    }
+    std::this_thread::sleep_for(PARK_SLEEP);
+    return true;
+}
+
+template<typename Hooks>
+void BasicScheduler<Hooks>::run(std::size_t index) {
+    scheduler_detail::tls_scheduler = this;
+    scheduler_detail::tls_worker = index;
+    Worker& self = *workerState[index];
+
+    constexpr std::size_t BATCH_CAP = 16;
+    std::array<Event, BATCH_CAP> buf;
+    while (running) {
+        std::optional<Event> local = self.deque.pop();
+        if (!local) local = self.inbox.pop();
+        if (local) {
+            markBusy(self);
+            if (executeEvent(*local, index))
+                countCompleted(self, 1);
+            continue;
+        }
+        std::size_t got = event_queue.pop_batch<BATCH_CAP>(buf.begin());
+        if (got == 0) {
+            if (runOne(index))
+                markBusy(self);
+            else if (!idle(self))
+                break;
+            continue;
+        }
+        markBusy(self);
+        self.batchCur = buf.data();
+        self.batchEnd = buf.data() + got;
+        std::size_t executed = 0;
+        while (self.batchCur != self.batchEnd)
+            executed += executeEvent(*self.batchCur++, index);
+        countCompleted(self, executed);
+    }
+    scheduler_detail::tls_scheduler = nullptr;
+} 
+template<typename Hooks>
+void BasicScheduler<Hooks>::alternate_run() {
+    while (running) {
+        auto task_opt = event_queue.pop();
+        if (task_opt.has_value() && executeEvent(task_opt.value(), workerState.size()))
+            externalCompleted.fetch_add(1, std::memory_order_release);
+        else 
+            std::this_thread::yield();
+    }
+}
+
+template<typename Hooks>
+void BasicScheduler<Hooks>::waitUntilFinished() {
+    std::size_t index;
+    assert(!currentWorker(index) && "use waitFor() from inside an event");
+    (void)index;
+    while (outstandingWork() != 0 && running)
+        std::this_thread::sleep_for(std::chrono::microseconds(5));
+}
+
+template<typename Hooks>
+void BasicScheduler<Hooks>::countSubmitted(const Event& event) {
+    hooks_.on_enqueue(event);
+    if (scheduler_detail::tls_scheduler == this) {
+        std::atomic<uint64_t>& c = workerState[scheduler_detail::tls_worker]->submitted;
+        c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    } else {
+        externalSubmitted.fetch_add(1, std::memory_order_release);
+    }
+}
+
+// Release pairs with the acquire in collectCounts(), so whoever sees the
+// completion also sees the event's effects and anything it submitted.
+template<typename Hooks>
+void BasicScheduler<Hooks>::countCompleted(Worker& self, std::size_t n) {
+    self.completed.store(self.completed.load(std::memory_order_relaxed) + n,
+                         std::memory_order_release);
+}
+
+template<typename Hooks>
+typename BasicScheduler<Hooks>::WorkCounts BasicScheduler<Hooks>::collectCounts() const {
+    WorkCounts c{stoppedSubmitted.load(std::memory_order_relaxed),
+                 stoppedCompleted.load(std::memory_order_relaxed)};
+    c.completed += externalCompleted.load(std::memory_order_acquire);
+    c.submitted += externalSubmitted.load(std::memory_order_acquire);
+    for (const auto& w : workerState) {
+        c.completed += w->completed.load(std::memory_order_acquire);
+        c.submitted += w->submitted.load(std::memory_order_acquire);
+    }
+    return c;
+}
+
+// Events submitted but not yet run. One pass over the slots isn't a
+// snapshot: an event counted as completed on one worker may have been
+// submitted on a slot read before that. Every count only grows, so two
+// identical passes in a row mean nothing moved in between and the sums
+// held at that instant. If they differ, work is still going on.
+template<typename Hooks>
+uint64_t BasicScheduler<Hooks>::outstandingWork() const {
+    WorkCounts first = collectCounts();
+    WorkCounts second = collectCounts();
+    if (first == second)
+        return second.submitted - second.completed;
+    return std::max<uint64_t>(1, second.submitted - second.completed);
+}
+
+// Returns false if the event was parked for a token instead of run; it is
+// still outstanding then and mustn't be counted as completed
+template<typename Hooks>
+bool BasicScheduler<Hooks>::executeEvent(Event& event, std::size_t worker) {
+    if (event.getResourceClass() != 0 && !event.holdsToken() && !acquireTokenFor(event))
+        return false;
+    hooks_.on_start(event, worker);
+    event.execute();
+    hooks_.on_finish(event, worker);
+    if (event.getResourceClass() != 0)
+        releaseToken(event.getResourceClass());
+    if (event.getId() != DETACHED_ID)
+        notifyFinished(event.getId());
+    return true;
+}
+
+template<typename Hooks>
+void BasicScheduler<Hooks>::notifyFinished(uint64_t id) {
+    TaskNode& node = taskNode(id);
+    typename TaskNode::Link* link = node.subscribers.exchange(TaskNode::closed(),
+                                                     std::memory_order_acq_rel);
+    while (link != nullptr && link != TaskNode::closed()) {
+        typename TaskNode::Link* next = link->next;
+        releaseEdge(*link->child);
+        delete link;
+        link = next;
+    }
+}
+
+template<typename Hooks>
+typename BasicScheduler<Hooks>::TaskNode& BasicScheduler<Hooks>::taskNode(uint64_t id) {
+    return taskNodes.find_or_emplace(id, id);
+}
+
+// For ids run directly as events (no deps): reopen the node so it can be
+// depended on again, and shut out addDependency() since it's already queued
+template<typename Hooks>
+typename BasicScheduler<Hooks>::TaskNode& BasicScheduler<Hooks>::beginTask(uint64_t id) {
+    TaskNode& node = taskNode(id);
+    node.pending.store(0, std::memory_order_relaxed);
+    typename TaskNode::Link* closed = TaskNode::closed();
+    node.subscribers.compare_exchange_strong(closed, nullptr, std::memory_order_acq_rel);
+    return node;
+}
+
+// Caller holds a count on child.pending for this edge. Returns false if the
+// parent had already finished, in which case the count is the caller's to drop.
+template<typename Hooks>
+bool BasicScheduler<Hooks>::addEdge(TaskNode& parent, TaskNode& child) {
+    auto* link = new typename TaskNode::Link{&child, parent.subscribers.load(std::memory_order_acquire)};
+    while (link->next != TaskNode::closed()) {
+        if (parent.subscribers.compare_exchange_weak(link->next, link,
+                std::memory_order_acq_rel, std::memory_order_acquire))
+            return true;
+    }
+    delete link;
+    return false;
+}
+
+template<typename Hooks>
+void BasicScheduler<Hooks>::releaseEdge(TaskNode& child) {
+    if (child.pending.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        return;
+    TaskNode* node = &child;
+    Event event{node->id, [node]() {
+        // Moved out so the captures go before dependents are released
+        std::function<void()> fn = std::move(node->fn);
+        fn();
+    }};
+    countSubmitted(event);
+    enqueue(std::move(event));
+}
+
+template<typename Hooks>
+bool BasicScheduler<Hooks>::addDependency(uint64_t from_task_id, uint64_t target_task_id) {
+    TaskNode& target = taskNode(target_task_id);
+    // Only a target that is still held back can take another parent
+    int64_t p = target.pending.load(std::memory_order_acquire);
+    do {
+        if (p <= 0) return false;
+    } while (!target.pending.compare_exchange_weak(p, p + 1,
+                 std::memory_order_acq_rel, std::memory_order_acquire));
+
+    if (addEdge(taskNode(from_task_id), target))
+        return true;
+    releaseEdge(target);
+    return false;
+}
+
+template<typename Hooks>
+bool BasicScheduler<Hooks>::isFinished(uint64_t id) {
+    const TaskNode* node = taskNodes.find(id);
+    return node != nullptr && node->finished();
+}
+
+template<typename Hooks>
+bool BasicScheduler<Hooks>::forget(uint64_t id) {
+    if (!isFinished(id))
+        return false;
+    return taskNodes.erase(id);
+}
+
+template<typename Hooks>
+BasicDependencyContext<Hooks>::BasicDependencyContext(BasicScheduler<Hooks>* sched, uint64_t id) noexcept
+    : scheduler_(sched), current_task_id_(id)
+{}
+
+template<typename Hooks>
+bool BasicDependencyContext<Hooks>::addDependency(uint64_t target_task_id) const {
+    return scheduler_->addDependency(current_task_id_, target_task_id);
+}
+
+#endif
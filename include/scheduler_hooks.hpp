@@ -0,0 +1,123 @@
+// scheduler_hooks.hpp
+#ifndef SCHEDULER_HOOKS_HPP
+#define SCHEDULER_HOOKS_HPP
+
+#include "event.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <memory>
+
+// Instrumentation points compiled into BasicScheduler<Hooks>
+//
+// The scheduler calls these inline on its hot paths, so with NoHooks they
+// compile away entirely. Custom hooks derive from NoHooks and hide only the
+// members they care about. Worker indices are those of workerIndex(); the
+// one past the last worker stands for threads outside the pool.
+//
+//   on_enqueue(event)          an event became known to the scheduler:
+//                              submitted, or released by its last parent
+//   on_start(event, worker)    right before the event's function runs
+//   on_finish(event, worker)   right after it returned, before dependents
+//                              are released; nests under helping waits
+//   on_workers(active, slots)  running worker count changed (start, elastic
+//                              grow/shrink, stop). slots only ever changes
+//                              in a call with active == 0, i.e. before any
+//                              worker thread exists.
+struct NoHooks {
+    void on_enqueue(const Event&) {}
+    void on_start(const Event&, std::size_t) {}
+    void on_finish(const Event&, std::size_t) {}
+    void on_workers(std::size_t, std::size_t) {}
+};
+
+// What -DTELEMETRY_ENABLED builds use: per-worker event counts and busy
+// time, plus pool size changes. Nothing is printed from the scheduler's
+// threads; read the counters or call report() with a stream of your own,
+// e.g. scheduler.hooks().report(std::cout) once the work is done.
+class TelemetryHooks : public NoHooks {
+public:
+    void on_enqueue(const Event&) {
+        enqueued_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void on_start(const Event&, std::size_t worker) {
+        Slot& s = slot(worker);
+        if (s.depth++ == 0) s.since = std::chrono::steady_clock::now();
+    }
+
+    void on_finish(const Event&, std::size_t worker) {
+        Slot& s = slot(worker);
+        s.events.fetch_add(1, std::memory_order_relaxed);
+        if (--s.depth == 0) {
+            auto busy = std::chrono::steady_clock::now() - s.since;
+            s.busy_ns.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(busy).count(),
+                                std::memory_order_relaxed);
+        }
+    }
+
+    // The controller and retiring workers call this concurrently
+    void on_workers(std::size_t active, std::size_t slots) {
+        active_.store(active, std::memory_order_relaxed);
+        poolChanges_.fetch_add(1, std::memory_order_relaxed);
+        std::size_t peak = peak_.load(std::memory_order_relaxed);
+        while (active > peak &&
+               !peak_.compare_exchange_weak(peak, active, std::memory_order_relaxed)) {}
+        if (active == 0 && slots + 1 != slot_count_) {
+            slots_ = std::make_unique<Slot[]>(slots + 1);
+            slot_count_ = slots + 1;
+        }
+    }
+
+    uint64_t enqueued() const { return enqueued_.load(std::memory_order_relaxed); }
+
+    uint64_t executed() const {
+        uint64_t total = 0;
+        for (std::size_t i = 0; i < slot_count_; ++i)
+            total += slots_[i].events.load(std::memory_order_relaxed);
+        return total;
+    }
+
+    // Last reported pool size and the largest one seen
+    std::size_t activeWorkers() const { return active_.load(std::memory_order_relaxed); }
+    std::size_t peakWorkers() const { return peak_.load(std::memory_order_relaxed); }
+    uint64_t poolChanges() const { return poolChanges_.load(std::memory_order_relaxed); }
+
+    void report(std::ostream& out) const {
+        out << "[Telemetry] " << enqueued() << " events enqueued, " << poolChanges()
+            << " pool size changes, peak of " << peakWorkers() << " workers\n";
+        for (std::size_t i = 0; i < slot_count_; ++i) {
+            const Slot& s = slots_[i];
+            uint64_t events = s.events.load(std::memory_order_relaxed);
+            if (events == 0) continue;
+            out << "[Telemetry] worker " << i << ": " << events << " events, "
+                << s.busy_ns.load(std::memory_order_relaxed) / 1000 << " µs busy\n";
+        }
+    }
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> events{0};
+        std::atomic<uint64_t> busy_ns{0};
+        // Owner only; threads outside the pool share the last slot but
+        // never execute events
+        uint32_t depth = 0;
+        std::chrono::steady_clock::time_point since;
+    };
+
+    Slot& slot(std::size_t worker) {
+        return slots_[worker < slot_count_ ? worker : slot_count_ - 1];
+    }
+
+    std::atomic<uint64_t>    enqueued_{0};
+    std::atomic<uint64_t>    poolChanges_{0};
+    std::atomic<std::size_t> active_{0};
+    std::atomic<std::size_t> peak_{0};
+    std::unique_ptr<Slot[]>  slots_ = std::make_unique<Slot[]>(1);
+    std::size_t              slot_count_ = 1;
+};
+
+#endif
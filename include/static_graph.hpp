@@ -0,0 +1,173 @@
+// static_graph.hpp
+#ifndef STATIC_GRAPH_HPP
+#define STATIC_GRAPH_HPP
+
+#include "scheduler.hpp"
+#include "event.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+#include <type_traits>
+
+// Compile-time task graphs
+//
+// Nodes are the callables passed to the graph (node I is the I-th one) and
+// edges are types, so in-degrees, the successor table (CSR) and a
+// topological order are all computed by the compiler. Callables are kept in
+// a tuple without type erasure; a run only resets a fixed array of atomic
+// counters and pushes untracked events, nothing is allocated per run.
+//
+//     enum : std::size_t { A, B, C, D };
+//     auto g = makeStaticGraph<Edges<Edge<A, B>, Edge<A, D>,
+//                                    Edge<B, C>, Edge<D, C>>>(a, b, c, d);
+//     g.runAndWait(scheduler);
+
+template<std::size_t From, std::size_t To>
+struct Edge {
+    static constexpr std::size_t from = From;
+    static constexpr std::size_t to   = To;
+};
+
+template<typename... Es>
+struct Edges {};
+
+template<typename EdgeList, typename... Fns>
+class StaticGraph;
+
+template<typename... Es, typename... Fns>
+class StaticGraph<Edges<Es...>, Fns...> {
+public:
+    static constexpr std::size_t NUM_NODES = sizeof...(Fns);
+    static constexpr std::size_t NUM_EDGES = sizeof...(Es);
+
+    static_assert(NUM_NODES > 0, "static graph needs at least one node");
+    static_assert(((Es::from < NUM_NODES && Es::to < NUM_NODES) && ...),
+                  "edge refers to a node that does not exist");
+    static_assert(((Es::from != Es::to) && ...), "self edge");
+
+private:
+    struct Table {
+        std::array<uint32_t, NUM_NODES>        in_degree{};
+        std::array<std::size_t, NUM_NODES + 1> offsets{};
+        std::array<std::size_t, NUM_EDGES>     successors{};
+        std::array<std::size_t, NUM_NODES>     order{};
+        std::size_t                            ordered = 0;
+    };
+
+    static constexpr Table build() {
+        constexpr std::size_t from[] = { Es::from..., 0 };
+        constexpr std::size_t to[]   = { Es::to..., 0 };
+        Table t{};
+        for (std::size_t e = 0; e < NUM_EDGES; ++e) {
+            ++t.in_degree[to[e]];
+            ++t.offsets[from[e] + 1];
+        }
+        for (std::size_t n = 0; n < NUM_NODES; ++n)
+            t.offsets[n + 1] += t.offsets[n];
+
+        std::array<std::size_t, NUM_NODES + 1> pos = t.offsets;
+        for (std::size_t e = 0; e < NUM_EDGES; ++e)
+            t.successors[pos[from[e]]++] = to[e];
+
+        // Kahn's algorithm, the order array doubles as the work list
+        std::array<uint32_t, NUM_NODES> deg = t.in_degree;
+        for (std::size_t n = 0; n < NUM_NODES; ++n)
+            if (deg[n] == 0) t.order[t.ordered++] = n;
+        for (std::size_t i = 0; i < t.ordered; ++i) {
+            std::size_t n = t.order[i];
+            for (std::size_t k = t.offsets[n]; k < t.offsets[n + 1]; ++k)
+                if (--deg[t.successors[k]] == 0)
+                    t.order[t.ordered++] = t.successors[k];
+        }
+        return t;
+    }
+
+    static constexpr Table TABLE = build();
+    static_assert(TABLE.ordered == NUM_NODES, "static graph has a cycle");
+
+public:
+    static constexpr const std::array<uint32_t, NUM_NODES>& in_degree = TABLE.in_degree;
+    static constexpr const std::array<std::size_t, NUM_NODES>& topological_order = TABLE.order;
+
+    explicit StaticGraph(Fns... fns) : fns_(std::move(fns)...) {}
+
+    StaticGraph(const StaticGraph&) = delete;
+    StaticGraph& operator=(const StaticGraph&) = delete;
+
+    // Pushes the roots; the rest is released as predecessors finish.
+    // A graph object runs one instance at a time.
+    void run(Scheduler& scheduler) {
+        assert(remaining_.load(std::memory_order_acquire) == 0 && "graph already running");
+        scheduler_ = &scheduler;
+        for (std::size_t n = 0; n < NUM_NODES; ++n)
+            pending_[n].store(TABLE.in_degree[n], std::memory_order_relaxed);
+        remaining_.store(NUM_NODES, std::memory_order_release);
+        for (std::size_t n = 0; n < NUM_NODES; ++n)
+            if (TABLE.in_degree[n] == 0) submit(n);
+    }
+
+    bool finished() const {
+        return remaining_.load(std::memory_order_acquire) == 0;
+    }
+
+    // Safe to call from inside an event, the caller helps instead of parking
+    void wait(Scheduler& scheduler) {
+        scheduler.waitFor([this] { return finished(); });
+    }
+
+    void runAndWait(Scheduler& scheduler) {
+        run(scheduler);
+        wait(scheduler);
+    }
+
+    // Runs every node on the calling thread in topological order
+    void runInline() {
+        for (std::size_t n : TABLE.order)
+            INVOKE[n](this);
+    }
+
+private:
+    template<std::size_t I>
+    static void invokeNode(StaticGraph* g) { std::get<I>(g->fns_)(); }
+
+    template<std::size_t... Is>
+    static constexpr auto makeInvokeTable(std::index_sequence<Is...>) {
+        return std::array<void (*)(StaticGraph*), NUM_NODES>{ &invokeNode<Is>... };
+    }
+
+    static constexpr std::array<void (*)(StaticGraph*), NUM_NODES> INVOKE =
+        makeInvokeTable(std::make_index_sequence<NUM_NODES>{});
+
+    void submit(std::size_t n) {
+        scheduler_->scheduleEvent(Event(Scheduler::DETACHED_ID, [this, n]() {
+            execute(n);
+        }));
+    }
+
+    void execute(std::size_t n) {
+        INVOKE[n](this);
+        for (std::size_t k = TABLE.offsets[n]; k < TABLE.offsets[n + 1]; ++k) {
+            std::size_t s = TABLE.successors[k];
+            if (pending_[s].fetch_sub(1, std::memory_order_acq_rel) == 1)
+                submit(s);
+        }
+        // Successors are queued before this drops, so 0 really means done
+        remaining_.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    std::tuple<Fns...>                          fns_;
+    Scheduler*                                  scheduler_ = nullptr;
+    std::array<std::atomic<uint32_t>, NUM_NODES> pending_{};
+    alignas(64) std::atomic<std::size_t>        remaining_{0};
+};
+
+template<typename EdgeList, typename... Fns>
+StaticGraph<EdgeList, std::decay_t<Fns>...> makeStaticGraph(Fns&&... fns) {
+    return StaticGraph<EdgeList, std::decay_t<Fns>...>(std::forward<Fns>(fns)...);
+}
+
+#endif
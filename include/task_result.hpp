@@ -0,0 +1,79 @@
+// task_result.hpp
+#ifndef TASK_RESULT_HPP
+#define TASK_RESULT_HPP
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <optional>
+#include <utility>
+
+template<typename Hooks>
+class BasicScheduler;
+
+// Handle to the value a typed task returns
+//
+// The value lives in a reference counted slot shared by every handle copy.
+// Dependents scheduled with a handle read the value in place through a
+// const reference and drop their reference as soon as they have run, so an
+// intermediate buffer is freed once its last consumer finished and nobody
+// else still holds a handle to it. get() is only valid once ready().
+template<typename T>
+class TaskResult {
+public:
+    TaskResult() = default;
+
+    TaskResult(const TaskResult& other) noexcept : id_(other.id_), slot_(other.slot_) {
+        if (slot_) slot_->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+    TaskResult(TaskResult&& other) noexcept
+        : id_(other.id_), slot_(std::exchange(other.slot_, nullptr)) {}
+
+    TaskResult& operator=(TaskResult other) noexcept {
+        std::swap(id_, other.id_);
+        std::swap(slot_, other.slot_);
+        return *this;
+    }
+
+    ~TaskResult() { release(); }
+
+    uint64_t id() const { return id_; }
+    explicit operator bool() const { return slot_ != nullptr; }
+
+    bool ready() const {
+        return slot_ && slot_->ready.load(std::memory_order_acquire);
+    }
+
+    const T& get() const {
+        assert(ready() && "result read before its task finished");
+        return *slot_->value;
+    }
+
+private:
+    template<typename> friend class BasicScheduler;
+
+    struct Slot {
+        std::atomic<uint32_t> refs{1};
+        std::atomic<bool>     ready{false};
+        std::optional<T>      value;
+    };
+
+    explicit TaskResult(uint64_t id) : id_(id), slot_(new Slot) {}
+
+    template<typename... Args>
+    void publish(Args&&... args) {
+        slot_->value.emplace(std::forward<Args>(args)...);
+        slot_->ready.store(true, std::memory_order_release);
+    }
+
+    void release() {
+        if (slot_ && slot_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            delete slot_;
+        slot_ = nullptr;
+    }
+
+    uint64_t id_ = 0;
+    Slot*    slot_ = nullptr;
+};
+
+#endif
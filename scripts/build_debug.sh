@@ -17,7 +17,7 @@ mkdir -p bin
 
 g++ -std=c++20 -pthread -Wall -Wextra -g -O0 \
   -I../include \
-  src/main.cpp src/scheduler.cpp src/Task.cpp \
+  src/main.cpp src/scheduler.cpp src/Task.cpp src/reactor.cpp \
   -o bin/$OUTPUT_NAME \
   $TELEMETRY_FLAG
 
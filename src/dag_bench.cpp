@@ -0,0 +1,46 @@
+#include "../include/dag_benchmark_suite.hpp"
+
+#include <climits>
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// dag_bench [cost_ns] [jitter_ns] [runs] [out_dir]
+// With out_dir, every generated graph is also written there as <shape>.bin
+// for graph_replay. cost_ns + jitter_ns must fit in 32 bits.
+int main(int argc, char** argv) {
+    if (argc > 5) {
+        std::cerr << "usage: " << argv[0] << " [cost_ns] [jitter_ns] [runs] [out_dir]\n";
+        return 1;
+    }
+
+    // The whole argument has to be a number in [min, max]
+    auto parse = [](const char* arg, uint64_t& value, uint64_t min, uint64_t max) {
+        std::istringstream ss(arg);
+        return static_cast<bool>(ss >> value) && (ss >> std::ws).eof() &&
+               value >= min && value <= max;
+    };
+
+    uint64_t mean = 1000, jitter = 0, runs = 5;
+    if ((argc > 1 && !parse(argv[1], mean, 0, UINT32_MAX)) ||
+        (argc > 2 && !parse(argv[2], jitter, 0, UINT32_MAX - mean)) ||
+        (argc > 3 && !parse(argv[3], runs, 1, INT_MAX))) {
+        std::cerr << "usage: " << argv[0] << " [cost_ns] [jitter_ns] [runs] [out_dir]\n"
+                  << "  cost_ns + jitter_ns < 2^32, runs >= 1\n";
+        return 1;
+    }
+
+    CostModel cost;
+    cost.mean_ns   = static_cast<uint32_t>(mean);
+    cost.jitter_ns = static_cast<uint32_t>(jitter);
+    std::string out_dir = argc > 4 ? argv[4] : "";
+
+    try {
+        DagBenchmarkSuite::RunAll(cost, static_cast<int>(runs), out_dir);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+}
@@ -0,0 +1,172 @@
+#include "../include/dag_generator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using EdgeList = std::vector<std::pair<uint32_t, uint32_t>>;
+
+// Largest node count whose ids all fit in uint32_t
+constexpr uint64_t MAX_NODES = UINT32_MAX;
+
+void checkNodes(uint64_t nodes, const char* shape) {
+    if (nodes > MAX_NODES)
+        throw std::invalid_argument(std::string(shape) + ": " + std::to_string(nodes) +
+                                    " nodes, ids must fit in 32 bits");
+}
+
+void checkCost(const CostModel& cost) {
+    if (uint64_t{cost.mean_ns} + cost.jitter_ns > UINT32_MAX)
+        throw std::invalid_argument("cost mean + jitter must fit in 32 bits");
+}
+
+GraphData build(uint64_t nodes, const EdgeList& edges, const CostModel& cost) {
+    std::mt19937_64 rng(cost.seed);
+    uint32_t lo = cost.mean_ns - std::min(cost.jitter_ns, cost.mean_ns);
+    uint32_t hi = cost.mean_ns + cost.jitter_ns;
+    std::uniform_int_distribution<uint32_t> dist(lo, hi);
+
+    std::vector<uint32_t> costs(nodes);
+    for (uint32_t& c : costs) c = lo == hi ? lo : dist(rng);
+    return GraphData::fromEdges(nodes, edges, std::move(costs),
+                                std::vector<uint16_t>(nodes, 0));
+}
+
+}
+
+GraphData makeIndependentDag(uint32_t nodes, const CostModel& cost) {
+    checkCost(cost);
+    return build(nodes, {}, cost);
+}
+
+GraphData makeChainDag(uint32_t length, const CostModel& cost) {
+    checkCost(cost);
+    EdgeList edges;
+    for (uint32_t n = 1; n < length; ++n) edges.emplace_back(n - 1, n);
+    return build(length, edges, cost);
+}
+
+GraphData makeFanOutInDag(uint32_t width, const CostModel& cost) {
+    checkNodes(uint64_t{width} + 2, "fan-out/in");
+    checkCost(cost);
+    const uint32_t sink = width + 1;
+    EdgeList edges;
+    for (uint32_t n = 1; n <= width; ++n) {
+        edges.emplace_back(0, n);
+        edges.emplace_back(n, sink);
+    }
+    return build(width + 2, edges, cost);
+}
+
+GraphData makeDiamondDag(uint32_t count, const CostModel& cost) {
+    checkNodes(3 * uint64_t{count} + 1, "diamond");
+    checkCost(cost);
+    EdgeList edges;
+    for (uint32_t d = 0; d < count; ++d) {
+        uint32_t top = 3 * d;
+        edges.emplace_back(top, top + 1);
+        edges.emplace_back(top, top + 2);
+        edges.emplace_back(top + 1, top + 3);
+        edges.emplace_back(top + 2, top + 3);
+    }
+    return build(3 * uint64_t{count} + 1, edges, cost);
+}
+
+// Batagelj & Brandes' skip method, walking the pairs (w, v) with w < v
+GraphData makeErdosRenyiDag(uint32_t nodes, double p, const CostModel& cost) {
+    if (!(p >= 0.0 && p <= 1.0))
+        throw std::invalid_argument("erdos-renyi: p must be in [0, 1]");
+    checkCost(cost);
+    EdgeList edges;
+    if (p == 1.0) {
+        for (uint32_t v = 1; v < nodes; ++v)
+            for (uint32_t w = 0; w < v; ++w) edges.emplace_back(w, v);
+    } else if (p > 0.0) {
+        std::mt19937_64 rng(cost.seed ^ 0x9e3779b97f4a7c15ull);
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+        const double log_q = std::log(1.0 - p);
+        int64_t v = 1, w = -1;
+        while (v < nodes) {
+            w += 1 + static_cast<int64_t>(std::floor(std::log(1.0 - uniform(rng)) / log_q));
+            while (w >= v && v < nodes) {
+                w -= v;
+                ++v;
+            }
+            if (v < nodes)
+                edges.emplace_back(static_cast<uint32_t>(w), static_cast<uint32_t>(v));
+        }
+    }
+    return build(nodes, edges, cost);
+}
+
+// Fork nodes are a heap-ordered tree (children of i at 2i+1, 2i+2). The
+// join for internal node i gets its id in reverse heap order, so joins of
+// deeper subtrees come first and every edge still points upwards in id.
+GraphData makeForkJoinDag(uint32_t depth, const CostModel& cost) {
+    // Checked before shifting, depth >= 63 would overflow the shift itself
+    if (depth > 30)
+        throw std::invalid_argument("fork-join: depth " + std::to_string(depth) +
+                                    " needs more than 2^32 nodes, at most 30");
+    checkCost(cost);
+    const uint64_t forks = (uint64_t{2} << depth) - 1;
+    const uint64_t internal = forks / 2;
+    auto join = [&](uint64_t i) { return forks + (internal - 1 - i); };
+    auto end = [&](uint64_t i) { return i < internal ? join(i) : i; };
+
+    EdgeList edges;
+    for (uint64_t i = 0; i < internal; ++i) {
+        for (uint64_t c : {2 * i + 1, 2 * i + 2}) {
+            edges.emplace_back(static_cast<uint32_t>(i), static_cast<uint32_t>(c));
+            edges.emplace_back(static_cast<uint32_t>(end(c)), static_cast<uint32_t>(join(i)));
+        }
+    }
+    return build(forks + internal, edges, cost);
+}
+
+GraphData makeStencilDag(uint32_t width, uint32_t steps, const CostModel& cost) {
+    checkNodes(uint64_t{width} * steps, "stencil");
+    checkCost(cost);
+    EdgeList edges;
+    for (uint32_t t = 1; t < steps; ++t) {
+        for (uint32_t x = 0; x < width; ++x) {
+            uint32_t cell = t * width + x;
+            uint32_t first = x == 0 ? 0 : x - 1;
+            uint32_t last = std::min(x + 1, width - 1);
+            for (uint32_t from = first; from <= last; ++from)
+                edges.emplace_back((t - 1) * width + from, cell);
+        }
+    }
+    return build(uint64_t{width} * steps, edges, cost);
+}
+
+DagProfile profileDag(const GraphView& graph) {
+    DagProfile profile;
+    std::vector<uint32_t> deg(graph.in_degree, graph.in_degree + graph.node_count);
+    std::vector<uint64_t> start(graph.node_count, 0);   // earliest start
+    std::vector<uint64_t> level(graph.node_count, 1);
+    std::vector<uint32_t> ready;
+    for (uint32_t n = 0; n < graph.node_count; ++n)
+        if (deg[n] == 0) ready.push_back(n);
+
+    while (!ready.empty()) {
+        uint32_t n = ready.back();
+        ready.pop_back();
+        uint64_t finish = start[n] + graph.cost_ns[n];
+        profile.work_ns += graph.cost_ns[n];
+        profile.span_ns = std::max(profile.span_ns, finish);
+        profile.depth = std::max(profile.depth, level[n]);
+        for (uint64_t k = graph.offsets[n]; k < graph.offsets[n + 1]; ++k) {
+            uint32_t s = graph.targets[k];
+            start[s] = std::max(start[s], finish);
+            level[s] = std::max(level[s], level[n] + 1);
+            if (--deg[s] == 0) ready.push_back(s);
+        }
+    }
+    return profile;
+}
@@ -0,0 +1,101 @@
+#include "../include/graph_file.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Converts a text task graph into the binary format read by graph_replay.
+//
+// Input, one record per line ('#' starts a comment):
+//     n <id> <cost_ns> [kernel]    node duration (nodes default to 0 ns)
+//     e <from> <to>                <to> runs after <from>
+// Node ids are dense, the node count is the largest id seen plus one. A
+// record whose id, cost or kernel doesn't fit the binary format is an error.
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::cerr << "usage: " << argv[0] << " <graph.txt> <graph.bin>\n";
+        return 1;
+    }
+    std::ifstream in(argv[1]);
+    if (!in) {
+        std::cerr << "cannot open " << argv[1] << "\n";
+        return 1;
+    }
+
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+    std::vector<uint32_t> cost;
+    std::vector<uint16_t> kernel;
+    uint64_t node_count = 0;
+    auto touch = [&](uint64_t id) {
+        if (id >= node_count) {
+            node_count = id + 1;
+            cost.resize(node_count, 0);
+            kernel.resize(node_count, 0);
+        }
+    };
+
+    // Node ids stay below UINT32_MAX so the node count fits in 32 bits
+    auto parse = [](std::istringstream& ss, uint64_t& value, uint64_t max) {
+        return static_cast<bool>(ss >> value) && value <= max;
+    };
+    auto atEnd = [](std::istringstream& ss) { return (ss >> std::ws).eof(); };
+
+    std::string line;
+    uint64_t line_no = 0;
+    while (std::getline(in, line)) {
+        ++line_no;
+        std::istringstream ss(line.substr(0, line.find('#')));
+        std::string kind;
+        if (!(ss >> kind)) continue;
+
+        // Unsigned extraction wraps "-1" around, the range checks catch it
+        uint64_t a = 0, b = 0, k = 0;
+        bool ok = false;
+        if (kind == "n") {
+            ok = parse(ss, a, UINT32_MAX - 1) && parse(ss, b, UINT32_MAX) &&
+                 (atEnd(ss) || (parse(ss, k, UINT16_MAX) && atEnd(ss)));
+        } else if (kind == "e") {
+            ok = parse(ss, a, UINT32_MAX - 1) && parse(ss, b, UINT32_MAX - 1) &&
+                 a != b && atEnd(ss);
+        }
+        if (!ok) {
+            std::cerr << argv[1] << ":" << line_no << ": bad record '" << line
+                      << "' (ids < " << UINT32_MAX << ", cost_ns < 2^32, kernel < 2^16)\n";
+            return 1;
+        }
+
+        try {
+            if (kind == "n") {
+                touch(a);
+                cost[a] = static_cast<uint32_t>(b);
+                kernel[a] = static_cast<uint16_t>(k);
+            } else {
+                touch(std::max(a, b));
+                edges.emplace_back(static_cast<uint32_t>(a), static_cast<uint32_t>(b));
+            }
+        } catch (const std::bad_alloc&) {
+            std::cerr << argv[1] << ":" << line_no << ": out of memory for '" << line << "'\n";
+            return 1;
+        }
+    }
+
+    GraphData graph = GraphData::fromEdges(node_count, edges, std::move(cost), std::move(kernel));
+    if (!graph.isAcyclic()) {
+        std::cerr << "graph has a cycle, it could never finish\n";
+        return 1;
+    }
+    try {
+        writeGraphFile(argv[2], graph.view());
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    std::cout << "Wrote " << argv[2] << ": " << node_count << " nodes, "
+              << edges.size() << " edges\n";
+}
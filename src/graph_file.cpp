@@ -0,0 +1,220 @@
+#include "../include/graph_file.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+// Section offsets and total size for a graph of the given size, shared by
+// reader and writer. Empty if the sizes don't fit in 64 bits, which only a
+// corrupt header can ask for.
+struct Layout {
+    GraphFileHeader header;
+    uint64_t        file_size;
+};
+
+uint64_t alignUp(uint64_t n) { return (n + 7) & ~uint64_t{7}; }
+
+std::optional<Layout> layoutFor(uint64_t nodes, uint64_t edges) {
+    if (nodes > UINT32_MAX)
+        return std::nullopt;
+    // With 32-bit node ids only the targets section can overflow; the
+    // node sections after it take less than 16 bytes per node
+    uint64_t target_bytes = 0, after_targets = 0;
+    const uint64_t offsets_offset = alignUp(sizeof(GraphFileHeader));
+    const uint64_t targets_offset = alignUp(offsets_offset + (nodes + 1) * sizeof(uint64_t));
+    if (__builtin_mul_overflow(edges, sizeof(uint32_t), &target_bytes) ||
+        __builtin_add_overflow(targets_offset, target_bytes, &after_targets) ||
+        after_targets > UINT64_MAX - 16 * (nodes + 1))
+        return std::nullopt;
+
+    Layout l{};
+    GraphFileHeader& h = l.header;
+    std::memcpy(h.magic, GRAPH_FILE_MAGIC, sizeof(h.magic));
+    h.version          = GRAPH_FILE_VERSION;
+    h.node_count       = nodes;
+    h.edge_count       = edges;
+    h.offsets_offset   = offsets_offset;
+    h.targets_offset   = targets_offset;
+    h.in_degree_offset = alignUp(after_targets);
+    h.cost_offset      = alignUp(h.in_degree_offset + nodes * sizeof(uint32_t));
+    h.kernel_offset    = alignUp(h.cost_offset + nodes * sizeof(uint32_t));
+    l.file_size        = h.kernel_offset + nodes * sizeof(uint16_t);
+    return l;
+}
+
+bool isAcyclic(const GraphView& g) {
+    std::vector<uint32_t> deg(g.in_degree, g.in_degree + g.node_count);
+    std::vector<uint32_t> ready;
+    for (uint32_t n = 0; n < g.node_count; ++n)
+        if (deg[n] == 0) ready.push_back(n);
+
+    uint64_t seen = 0;
+    while (!ready.empty()) {
+        uint32_t n = ready.back();
+        ready.pop_back();
+        ++seen;
+        for (uint64_t k = g.offsets[n]; k < g.offsets[n + 1]; ++k)
+            if (--deg[g.targets[k]] == 0) ready.push_back(g.targets[k]);
+    }
+    return seen == g.node_count;
+}
+
+// Everything a replay indexes with, so a corrupt file is rejected here
+// instead of sending it out of bounds or waiting forever on a node whose
+// count never reaches zero. Returns what is wrong, or null.
+const char* checkContents(const GraphView& g) {
+    if (g.offsets[0] != 0)
+        return "offsets don't start at 0";
+    for (uint64_t n = 0; n < g.node_count; ++n)
+        if (g.offsets[n + 1] < g.offsets[n])
+            return "offsets decrease";
+    if (g.offsets[g.node_count] != g.edge_count)
+        return "offsets don't end at edge_count";
+
+    std::vector<uint32_t> unseen(g.in_degree, g.in_degree + g.node_count);
+    for (uint64_t k = 0; k < g.edge_count; ++k) {
+        uint32_t t = g.targets[k];
+        if (t >= g.node_count)
+            return "edge target out of range";
+        if (unseen[t]-- == 0)
+            return "in_degree doesn't match the edges";
+    }
+    for (uint32_t left : unseen)
+        if (left != 0)
+            return "in_degree doesn't match the edges";
+
+    if (!isAcyclic(g))
+        return "graph has a cycle";
+    return nullptr;
+}
+
+}
+
+GraphData GraphData::fromEdges(uint64_t node_count,
+                               const std::vector<std::pair<uint32_t, uint32_t>>& edges,
+                               std::vector<uint32_t> cost,
+                               std::vector<uint16_t> kernels) {
+    GraphData g;
+    g.offsets.assign(node_count + 1, 0);
+    g.in_degree.assign(node_count, 0);
+    g.targets.resize(edges.size());
+    g.cost_ns = std::move(cost);
+    g.kernel  = std::move(kernels);
+
+    for (auto [from, to] : edges) {
+        ++g.offsets[from + 1];
+        ++g.in_degree[to];
+    }
+    for (uint64_t n = 0; n < node_count; ++n)
+        g.offsets[n + 1] += g.offsets[n];
+
+    std::vector<uint64_t> pos(g.offsets.begin(), g.offsets.end() - 1);
+    for (auto [from, to] : edges)
+        g.targets[pos[from]++] = to;
+    return g;
+}
+
+GraphView GraphData::view() const {
+    GraphView v;
+    v.node_count = in_degree.size();
+    v.edge_count = targets.size();
+    v.offsets    = offsets.data();
+    v.targets    = targets.data();
+    v.in_degree  = in_degree.data();
+    v.cost_ns    = cost_ns.data();
+    v.kernel     = kernel.data();
+    return v;
+}
+
+bool GraphData::isAcyclic() const {
+    return ::isAcyclic(view());
+}
+
+GraphFile::GraphFile(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("cannot open graph file " + path);
+
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(GraphFileHeader)) {
+        ::close(fd);
+        throw std::runtime_error("graph file too small: " + path);
+    }
+    size_ = static_cast<std::size_t>(st.st_size);
+    data_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data_ == MAP_FAILED) {
+        data_ = nullptr;
+        throw std::runtime_error("cannot mmap graph file " + path);
+    }
+
+    const auto* base = static_cast<const unsigned char*>(data_);
+    GraphFileHeader h;
+    std::memcpy(&h, base, sizeof(h));
+    std::optional<Layout> expected = layoutFor(h.node_count, h.edge_count);
+    if (std::memcmp(h.magic, GRAPH_FILE_MAGIC, sizeof(h.magic)) != 0 ||
+        h.version != GRAPH_FILE_VERSION ||
+        !expected ||
+        h.offsets_offset != expected->header.offsets_offset ||
+        h.targets_offset != expected->header.targets_offset ||
+        h.in_degree_offset != expected->header.in_degree_offset ||
+        h.cost_offset != expected->header.cost_offset ||
+        h.kernel_offset != expected->header.kernel_offset ||
+        expected->file_size > size_) {
+        ::munmap(data_, size_);
+        data_ = nullptr;
+        throw std::runtime_error("not a valid graph file: " + path);
+    }
+
+    view_.node_count = h.node_count;
+    view_.edge_count = h.edge_count;
+    view_.offsets    = reinterpret_cast<const uint64_t*>(base + h.offsets_offset);
+    view_.targets    = reinterpret_cast<const uint32_t*>(base + h.targets_offset);
+    view_.in_degree  = reinterpret_cast<const uint32_t*>(base + h.in_degree_offset);
+    view_.cost_ns    = reinterpret_cast<const uint32_t*>(base + h.cost_offset);
+    view_.kernel     = reinterpret_cast<const uint16_t*>(base + h.kernel_offset);
+
+    // The check reads every section anyway, start paging it all in
+    ::madvise(data_, size_, MADV_WILLNEED);
+    if (const char* problem = checkContents(view_)) {
+        ::munmap(data_, size_);
+        data_ = nullptr;
+        throw std::runtime_error("corrupt graph file " + path + ": " + problem);
+    }
+}
+
+GraphFile::~GraphFile() {
+    if (data_) ::munmap(data_, size_);
+}
+
+void writeGraphFile(const std::string& path, const GraphView& g) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+        throw std::runtime_error("cannot write graph file " + path);
+
+    std::optional<Layout> layout = layoutFor(g.node_count, g.edge_count);
+    if (!layout)
+        throw std::runtime_error("graph too large for the file format: " + path);
+    const GraphFileHeader& h = layout->header;
+    auto section = [&out](uint64_t at, const void* data, std::size_t bytes) {
+        static const char zeros[8] = {};
+        out.write(zeros, static_cast<std::streamsize>(at - static_cast<uint64_t>(out.tellp())));
+        out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+    };
+    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    section(h.offsets_offset,   g.offsets,   (g.node_count + 1) * sizeof(uint64_t));
+    section(h.targets_offset,   g.targets,   g.edge_count * sizeof(uint32_t));
+    section(h.in_degree_offset, g.in_degree, g.node_count * sizeof(uint32_t));
+    section(h.cost_offset,      g.cost_ns,   g.node_count * sizeof(uint32_t));
+    section(h.kernel_offset,    g.kernel,    g.node_count * sizeof(uint16_t));
+    if (!out)
+        throw std::runtime_error("failed writing graph file " + path);
+}
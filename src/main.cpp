@@ -1,5 +1,5 @@
 #include "../include/benchmark_suite.hpp"
 
 int main() {
-    BenchmarkSuite::VerifyAll();
+    return BenchmarkSuite::VerifyAll() == 0 ? 0 : 1;
 }
\ No newline at end of file
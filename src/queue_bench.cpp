@@ -0,0 +1,5 @@
+#include "../include/queue_benchmark_suite.hpp"
+
+int main() {
+    QueueBenchmarkSuite::RunAll();
+}
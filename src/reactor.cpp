@@ -0,0 +1,552 @@
+#include "../include/reactor.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <queue>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Backend interface, only ever driven from the reactor thread (wake() aside)
+class ReactorBackend {
+public:
+    virtual ~ReactorBackend() = default;
+    virtual void submit(IoRequest* request) = 0;
+    // Blocks until at least one completion or a wake(), appends what finished
+    virtual void wait(std::vector<IoRequest*>& done) = 0;
+    virtual void wake() = 0;
+    // Shutdown: appends every request still held, each with its result set
+    // (-ECANCELED unless it completed anyway). Nothing touches a request's
+    // buffer after this returns.
+    virtual void cancelAll(std::vector<IoRequest*>& done) = 0;
+};
+
+namespace {
+
+int64_t resultOf(ssize_t n) { return n < 0 ? -static_cast<int64_t>(errno) : n; }
+
+// Runs a read/write/accept right now, for fds that are ready (or regular
+// files, which epoll considers always ready)
+int64_t performNow(IoRequest& r) {
+    switch (r.op) {
+        case IoOp::Read:
+            return resultOf(r.offset >= 0 ? ::pread(r.fd, r.buf, r.len, r.offset)
+                                          : ::read(r.fd, r.buf, r.len));
+        case IoOp::Write:
+            return resultOf(r.offset >= 0 ? ::pwrite(r.fd, r.buf, r.len, r.offset)
+                                          : ::write(r.fd, r.buf, r.len));
+        case IoOp::Accept:
+            return resultOf(::accept4(r.fd, nullptr, nullptr, SOCK_CLOEXEC));
+        case IoOp::Timeout:
+            break;
+    }
+    return 0;
+}
+
+// ------- IO_URING BACKEND --------
+
+class UringBackend final : public ReactorBackend {
+public:
+    // Returns null if the kernel (or a seccomp policy) refuses io_uring
+    static std::unique_ptr<UringBackend> create(unsigned entries) {
+        auto b = std::unique_ptr<UringBackend>(new UringBackend());
+        return b->init(entries) ? std::move(b) : nullptr;
+    }
+
+    ~UringBackend() override {
+        if (sq_ptr_ && sq_ptr_ != MAP_FAILED) ::munmap(sq_ptr_, sq_size_);
+        if (cq_ptr_ && cq_ptr_ != sq_ptr_ && cq_ptr_ != MAP_FAILED) ::munmap(cq_ptr_, cq_size_);
+        if (sqes_ && sqes_ != MAP_FAILED) ::munmap(sqes_, sqes_size_);
+        if (ring_fd_ >= 0) ::close(ring_fd_);
+        if (event_fd_ >= 0) ::close(event_fd_);
+    }
+
+    void submit(IoRequest* r) override {
+        // Never let more ops be in flight than the CQ can hold
+        if (in_flight_.size() >= cq_entries_ || !pushSqe(r)) {
+            backlog_.push_back(r);
+            return;
+        }
+        in_flight_.insert(r);
+    }
+
+    void wait(std::vector<IoRequest*>& done) override {
+        if (!wake_armed_) armWake();
+        enter(pending_, 1, IORING_ENTER_GETEVENTS);
+        pending_ = 0;
+        reap(done);
+
+        while (!backlog_.empty() && in_flight_.size() < cq_entries_ && pushSqe(backlog_.front())) {
+            in_flight_.insert(backlog_.front());
+            backlog_.pop_front();
+        }
+    }
+
+    // The kernel owns in-flight buffers until their CQE, so each op (and
+    // the eventfd read) is cancelled and reaped before returning. An op
+    // that finished first keeps its real result.
+    void cancelAll(std::vector<IoRequest*>& done) override {
+        for (IoRequest* r : backlog_) {
+            r->result = -ECANCELED;
+            done.push_back(r);
+        }
+        backlog_.clear();
+
+        std::vector<IoRequest*> targets(in_flight_.begin(), in_flight_.end());
+        std::size_t next = 0;
+        bool wake_cancelled = !wake_armed_;
+        while (!in_flight_.empty() || wake_armed_) {
+            while (next < targets.size() && pushCancel(targets[next])) ++next;
+            if (!wake_cancelled && pushCancel(nullptr)) wake_cancelled = true;
+            enter(pending_, 1, IORING_ENTER_GETEVENTS);
+            pending_ = 0;
+            reap(done);
+        }
+    }
+
+    void wake() override {
+        uint64_t one = 1;
+        [[maybe_unused]] ssize_t n = ::write(event_fd_, &one, sizeof(one));
+    }
+
+private:
+    static constexpr uint64_t WAKE_TAG = 0;
+    static constexpr uint64_t CANCEL_TAG = 1;       // requests are 8-byte aligned
+
+    UringBackend() = default;
+
+    bool init(unsigned entries) {
+        event_fd_ = ::eventfd(0, EFD_CLOEXEC);
+        if (event_fd_ < 0) return false;
+
+        io_uring_params p{};
+        ring_fd_ = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &p));
+        if (ring_fd_ < 0) return false;
+
+        sq_size_ = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+        cq_size_ = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+        bool single = p.features & IORING_FEAT_SINGLE_MMAP;
+        if (single) sq_size_ = cq_size_ = std::max(sq_size_, cq_size_);
+
+        sq_ptr_ = ::mmap(nullptr, sq_size_, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+        if (sq_ptr_ == MAP_FAILED) return false;
+        cq_ptr_ = single ? sq_ptr_
+                         : ::mmap(nullptr, cq_size_, PROT_READ | PROT_WRITE,
+                                  MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING);
+        if (cq_ptr_ == MAP_FAILED) return false;
+        sqes_size_ = p.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = ::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+        if (sqes_ == MAP_FAILED) return false;
+
+        auto* sq = static_cast<char*>(sq_ptr_);
+        sq_head_  = reinterpret_cast<unsigned*>(sq + p.sq_off.head);
+        sq_tail_  = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+        sq_mask_  = reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+        sq_array_ = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+        sq_entries_ = p.sq_entries;
+
+        auto* cq = static_cast<char*>(cq_ptr_);
+        cq_head_ = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+        cq_tail_ = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+        cq_mask_ = reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+        cqes_    = reinterpret_cast<io_uring_cqe*>(cq + p.cq_off.cqes);
+        // One CQ slot stays reserved for the eventfd read
+        cq_entries_ = p.cq_entries - 1;
+        return true;
+    }
+
+    io_uring_sqe* nextSqe() {
+        unsigned tail = *sq_tail_;
+        if (tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_) {
+            enter(pending_, 0, 0);                // SQ full, hand it over
+            pending_ = 0;
+            if (tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_)
+                return nullptr;
+        }
+        unsigned idx = tail & *sq_mask_;
+        io_uring_sqe* sqe = &static_cast<io_uring_sqe*>(sqes_)[idx];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sq_array_[idx] = idx;
+        return sqe;
+    }
+
+    void commitSqe() {
+        __atomic_store_n(sq_tail_, *sq_tail_ + 1, __ATOMIC_RELEASE);
+        ++pending_;
+    }
+
+    bool pushSqe(IoRequest* r) {
+        io_uring_sqe* sqe = nextSqe();
+        if (!sqe) return false;
+        sqe->fd = r->fd;
+        sqe->user_data = reinterpret_cast<uint64_t>(r);
+        switch (r->op) {
+            case IoOp::Read:
+            case IoOp::Write:
+                sqe->opcode = r->op == IoOp::Read ? IORING_OP_READ : IORING_OP_WRITE;
+                sqe->addr = reinterpret_cast<uint64_t>(r->buf);
+                sqe->len = static_cast<uint32_t>(r->len);
+                sqe->off = r->offset >= 0 ? static_cast<uint64_t>(r->offset) : ~uint64_t{0};
+                break;
+            case IoOp::Accept:
+                sqe->opcode = IORING_OP_ACCEPT;
+                sqe->accept_flags = SOCK_CLOEXEC;
+                break;
+            case IoOp::Timeout:
+                r->timespec[0] = r->timeout_ns / 1'000'000'000;
+                r->timespec[1] = r->timeout_ns % 1'000'000'000;
+                sqe->opcode = IORING_OP_TIMEOUT;
+                sqe->fd = -1;
+                sqe->addr = reinterpret_cast<uint64_t>(r->timespec);
+                sqe->len = 1;
+                break;
+        }
+        commitSqe();
+        return true;
+    }
+
+    // Keeps one read on the eventfd outstanding so wake() ends a wait
+    void armWake() {
+        io_uring_sqe* sqe = nextSqe();
+        if (!sqe) return;
+        sqe->opcode = IORING_OP_READ;
+        sqe->fd = event_fd_;
+        sqe->addr = reinterpret_cast<uint64_t>(&wake_buf_);
+        sqe->len = sizeof(wake_buf_);
+        sqe->user_data = WAKE_TAG;
+        commitSqe();
+        wake_armed_ = true;
+    }
+
+    // Cancels r's op, or the eventfd read for null
+    bool pushCancel(IoRequest* r) {
+        io_uring_sqe* sqe = nextSqe();
+        if (!sqe) return false;
+        sqe->opcode = r && r->op == IoOp::Timeout ? IORING_OP_TIMEOUT_REMOVE
+                                                  : IORING_OP_ASYNC_CANCEL;
+        sqe->fd = -1;
+        sqe->addr = r ? reinterpret_cast<uint64_t>(r) : WAKE_TAG;
+        sqe->user_data = CANCEL_TAG;
+        commitSqe();
+        return true;
+    }
+
+    void reap(std::vector<IoRequest*>& done) {
+        unsigned head = __atomic_load_n(cq_head_, __ATOMIC_RELAXED);
+        unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+        for (; head != tail; ++head) {
+            const io_uring_cqe& cqe = cqes_[head & *cq_mask_];
+            if (cqe.user_data == CANCEL_TAG) continue;
+            if (cqe.user_data == WAKE_TAG) {
+                wake_armed_ = false;
+                continue;
+            }
+            auto* r = reinterpret_cast<IoRequest*>(cqe.user_data);
+            r->result = (r->op == IoOp::Timeout && cqe.res == -ETIME) ? 0 : cqe.res;
+            done.push_back(r);
+            in_flight_.erase(r);
+        }
+        __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    }
+
+    void enter(unsigned to_submit, unsigned min_complete, unsigned flags) {
+        while (::syscall(__NR_io_uring_enter, ring_fd_, to_submit, min_complete,
+                         flags, nullptr, 0) < 0 && errno == EINTR) {}
+    }
+
+    int   ring_fd_ = -1;
+    int   event_fd_ = -1;
+    void* sq_ptr_ = nullptr;
+    void* cq_ptr_ = nullptr;
+    void* sqes_ = nullptr;
+    std::size_t sq_size_ = 0, cq_size_ = 0, sqes_size_ = 0;
+
+    unsigned* sq_head_ = nullptr;
+    unsigned* sq_tail_ = nullptr;
+    unsigned* sq_mask_ = nullptr;
+    unsigned* sq_array_ = nullptr;
+    unsigned  sq_entries_ = 0;
+    unsigned* cq_head_ = nullptr;
+    unsigned* cq_tail_ = nullptr;
+    unsigned* cq_mask_ = nullptr;
+    io_uring_cqe* cqes_ = nullptr;
+    unsigned  cq_entries_ = 0;
+
+    unsigned pending_ = 0;      // SQEs queued but not yet handed to the kernel
+    std::unordered_set<IoRequest*> in_flight_;      // what cancelAll() must cancel
+    bool     wake_armed_ = false;
+    uint64_t wake_buf_ = 0;
+    std::deque<IoRequest*> backlog_;
+};
+
+// ------- EPOLL BACKEND --------
+
+class EpollBackend final : public ReactorBackend {
+public:
+    EpollBackend() {
+        epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+        event_fd_ = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = event_fd_;
+        ::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, event_fd_, &ev);
+    }
+
+    ~EpollBackend() override {
+        ::close(event_fd_);
+        ::close(epoll_fd_);
+    }
+
+    void submit(IoRequest* r) override {
+        if (r->op == IoOp::Timeout) {
+            timers_.push({Clock::now() + std::chrono::nanoseconds(r->timeout_ns), r});
+            return;
+        }
+        FdState& st = fds_[r->fd];
+        std::deque<IoRequest*>& queue = r->op == IoOp::Write ? st.writers : st.readers;
+        queue.push_back(r);
+        int err = updateInterest(r->fd, st);
+        if (err == 0) return;
+
+        // Only this request is affected, others queued on the fd stay
+        queue.pop_back();
+        if (err == EPERM) {
+            ready_.push_back(r);        // regular files can't be polled and never block for long
+        } else {
+            r->result = -err;
+            failed_.push_back(r);
+        }
+        if (st.readers.empty() && st.writers.empty())
+            fds_.erase(r->fd);
+    }
+
+    void wait(std::vector<IoRequest*>& done) override {
+        for (IoRequest* r : ready_) {
+            r->result = performNow(*r);
+            done.push_back(r);
+        }
+        done.insert(done.end(), failed_.begin(), failed_.end());
+        bool had_ready = !ready_.empty() || !failed_.empty();
+        ready_.clear();
+        failed_.clear();
+
+        int timeout_ms = -1;
+        if (had_ready) timeout_ms = 0;
+        else if (!timers_.empty()) {
+            auto until = timers_.top().first - Clock::now();
+            auto ms = std::chrono::ceil<std::chrono::milliseconds>(until).count();
+            timeout_ms = ms < 0 ? 0 : static_cast<int>(ms);
+        }
+
+        epoll_event events[64];
+        int n = ::epoll_wait(epoll_fd_, events, 64, timeout_ms);
+        for (int i = 0; i < n; ++i) {
+            int fd = events[i].data.fd;
+            if (fd == event_fd_) {
+                uint64_t drained;
+                [[maybe_unused]] ssize_t r = ::read(event_fd_, &drained, sizeof(drained));
+                continue;
+            }
+            auto it = fds_.find(fd);
+            if (it == fds_.end()) continue;
+            FdState& st = it->second;
+            uint32_t e = events[i].events;
+            if ((e & (EPOLLIN | EPOLLERR | EPOLLHUP)) && !st.readers.empty()) {
+                finishFront(st.readers, done);
+            }
+            if ((e & (EPOLLOUT | EPOLLERR | EPOLLHUP)) && !st.writers.empty()) {
+                finishFront(st.writers, done);
+            }
+            if (st.readers.empty() && st.writers.empty()) {
+                ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+                fds_.erase(it);
+            } else if (int err = updateInterest(fd, st)) {
+                // The fd went bad under us (closed?), nothing left on it can run
+                failAll(st, -err, done);
+                fds_.erase(it);
+            }
+        }
+
+        auto now = Clock::now();
+        while (!timers_.empty() && timers_.top().first <= now) {
+            IoRequest* r = timers_.top().second;
+            timers_.pop();
+            r->result = 0;
+            done.push_back(r);
+        }
+    }
+
+    void wake() override {
+        uint64_t one = 1;
+        [[maybe_unused]] ssize_t n = ::write(event_fd_, &one, sizeof(one));
+    }
+
+    void cancelAll(std::vector<IoRequest*>& done) override {
+        for (auto& [fd, st] : fds_) {
+            ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+            failAll(st, -ECANCELED, done);
+        }
+        fds_.clear();
+        for (IoRequest* r : ready_) {
+            r->result = -ECANCELED;
+            done.push_back(r);
+        }
+        ready_.clear();
+        done.insert(done.end(), failed_.begin(), failed_.end());
+        failed_.clear();
+        while (!timers_.empty()) {
+            IoRequest* r = timers_.top().second;
+            timers_.pop();
+            r->result = -ECANCELED;
+            done.push_back(r);
+        }
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct FdState {
+        std::deque<IoRequest*> readers;     // reads and accepts, in order
+        std::deque<IoRequest*> writers;
+        uint32_t               interest = 0;
+    };
+
+    struct Later {
+        bool operator()(const std::pair<Clock::time_point, IoRequest*>& a,
+                        const std::pair<Clock::time_point, IoRequest*>& b) const {
+            return a.first > b.first;
+        }
+    };
+
+    static void failAll(FdState& st, int64_t result, std::vector<IoRequest*>& done) {
+        for (std::deque<IoRequest*>* q : {&st.readers, &st.writers}) {
+            for (IoRequest* r : *q) {
+                r->result = result;
+                done.push_back(r);
+            }
+            q->clear();
+        }
+    }
+
+    static void finishFront(std::deque<IoRequest*>& q, std::vector<IoRequest*>& done) {
+        IoRequest* r = q.front();
+        q.pop_front();
+        r->result = performNow(*r);
+        done.push_back(r);
+    }
+
+    // 0 or the errno of a failed registration (EPERM: a regular file)
+    int updateInterest(int fd, FdState& st) {
+        uint32_t want = (st.readers.empty() ? 0 : uint32_t(EPOLLIN)) |
+                        (st.writers.empty() ? 0 : uint32_t(EPOLLOUT));
+        if (want == st.interest) return 0;
+        epoll_event ev{};
+        ev.events = want;
+        ev.data.fd = fd;
+        int op = st.interest == 0 ? EPOLL_CTL_ADD : EPOLL_CTL_MOD;
+        if (::epoll_ctl(epoll_fd_, op, fd, &ev) != 0)
+            return errno;
+        st.interest = want;
+        return 0;
+    }
+
+    int epoll_fd_ = -1;
+    int event_fd_ = -1;
+    std::unordered_map<int, FdState> fds_;
+    std::vector<IoRequest*> ready_;
+    std::vector<IoRequest*> failed_;        // result already set
+    std::priority_queue<std::pair<Clock::time_point, IoRequest*>,
+                        std::vector<std::pair<Clock::time_point, IoRequest*>>, Later> timers_;
+};
+
+}
+
+Reactor::Reactor(Scheduler& scheduler, Backend preferred, unsigned queue_depth)
+    : scheduler_(scheduler), backend_kind_(Backend::Epoll),
+      submissions_(SUBMIT_QUEUE_CAPACITY) {
+    if (preferred == Backend::IoUring) {
+        if (auto uring = UringBackend::create(queue_depth)) {
+            backend_ = std::move(uring);
+            backend_kind_ = Backend::IoUring;
+        }
+    }
+    if (!backend_)
+        backend_ = std::make_unique<EpollBackend>();
+    thread_ = std::thread(&Reactor::loop, this);
+}
+
+// Every outstanding request completes before the reactor goes away:
+// whatever the backend still holds is cancelled, and requests submitted
+// meanwhile (say by a callback reacting to its -ECANCELED) are cancelled
+// straight from the ring until all completions have run.
+Reactor::~Reactor() {
+    stopping_.store(true);
+    backend_->wake();
+    thread_.join();
+
+    std::vector<IoRequest*> cancelled;
+    backend_->cancelAll(cancelled);
+    for (IoRequest* r : cancelled)
+        deliver(r);
+    scheduler_.waitFor([this] {
+        while (std::optional<IoRequest*> r = submissions_.pop()) {
+            (*r)->result = -ECANCELED;
+            deliver(*r);
+        }
+        return outstanding_.load(std::memory_order_acquire) == 0;
+    });
+}
+
+void Reactor::submit(IoRequest* request) {
+    outstanding_.fetch_add(1, std::memory_order_relaxed);
+    submissions_.push(std::move(request));
+    // Pairs with the fence in loop(): either it sees our request before
+    // sleeping, or we see it asleep and wake it
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping_.load(std::memory_order_relaxed))
+        backend_->wake();
+}
+
+void Reactor::deliver(IoRequest* request) {
+    scheduler_.scheduleEvent(Event(Scheduler::DETACHED_ID, [this, request]() {
+        request->complete(request);
+        // Last touch of the reactor, the destructor may proceed after this
+        outstanding_.fetch_sub(1, std::memory_order_release);
+    }));
+}
+
+void Reactor::loop() {
+    std::vector<IoRequest*> done;
+    done.reserve(MAX_BATCH);
+    while (!stopping_.load()) {
+        while (std::optional<IoRequest*> r = submissions_.pop())
+            backend_->submit(*r);
+
+        sleeping_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (std::optional<IoRequest*> r = submissions_.pop()) {
+            sleeping_.store(false, std::memory_order_relaxed);
+            backend_->submit(*r);
+            continue;
+        }
+        if (stopping_.load()) break;
+
+        backend_->wait(done);
+        sleeping_.store(false, std::memory_order_relaxed);
+        for (IoRequest* r : done)
+            deliver(r);
+        done.clear();
+    }
+}
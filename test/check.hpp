@@ -0,0 +1,32 @@
+// check.hpp
+#ifndef CHECK_HPP
+#define CHECK_HPP
+
+#include <iostream>
+
+// Minimal assertions for the test programs: a failed CHECK is reported
+// and the program carries on, main() returns checkResult().
+inline int& checkFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(cond)                                                          \
+    do {                                                                     \
+        if (!(cond)) {                                                       \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #cond     \
+                      << ") failed\n";                                       \
+            ++checkFailures();                                               \
+        }                                                                    \
+    } while (0)
+
+inline int checkResult(const char* name) {
+    if (checkFailures() == 0) {
+        std::cout << "[Test] " << name << " passed\n";
+        return 0;
+    }
+    std::cout << "[Test] " << name << ": " << checkFailures() << " checks failed\n";
+    return 1;
+}
+
+#endif
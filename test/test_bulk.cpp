@@ -0,0 +1,57 @@
+#include "../include/scheduler.hpp"
+#include "check.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+// Every index of a detached bulk runs exactly once, and the handle it
+// returns is what a caller waits on
+static void detachedBulkHandle(Scheduler& scheduler) {
+    constexpr std::size_t N = 100'000;
+    std::vector<std::atomic<uint8_t>> hits(N);
+    BulkHandle bulk = scheduler.scheduleBulk(Scheduler::DETACHED_ID, 0, N,
+        [&hits](std::size_t i) { hits[i].fetch_add(1, std::memory_order_relaxed); }, 64);
+    scheduler.waitFor(bulk);
+
+    CHECK(bulk.done());
+    std::size_t once = 0;
+    for (auto& h : hits) once += h.load(std::memory_order_relaxed) == 1;
+    CHECK(once == N);
+}
+
+// Claims next to SIZE_MAX must not wrap the cursor around to 0
+static void rangeEndingAtSizeMax(Scheduler& scheduler) {
+    constexpr std::size_t N = 10'000;
+    const std::size_t begin = SIZE_MAX - N;
+    std::vector<std::atomic<uint8_t>> hits(N);
+    std::atomic<std::size_t> outside = 0;
+    BulkHandle bulk = scheduler.scheduleBulk(Scheduler::DETACHED_ID, begin, SIZE_MAX,
+        [&](std::size_t i) {
+            if (i < begin) outside.fetch_add(1, std::memory_order_relaxed);
+            else hits[i - begin].fetch_add(1, std::memory_order_relaxed);
+        }, 3);
+    scheduler.waitFor(bulk);
+
+    CHECK(outside == 0);
+    std::size_t once = 0;
+    for (auto& h : hits) once += h.load(std::memory_order_relaxed) == 1;
+    CHECK(once == N);
+}
+
+static void emptyRangeIsDone(Scheduler& scheduler) {
+    BulkHandle bulk = scheduler.scheduleBulk(Scheduler::DETACHED_ID, 5, 5, [](std::size_t) {});
+    CHECK(bulk.done());
+    scheduler.scheduleBulk(7, 5, 5, [](std::size_t) {});
+    CHECK(scheduler.isFinished(7));
+}
+
+int main() {
+    Scheduler scheduler;
+    scheduler.start();
+    detachedBulkHandle(scheduler);
+    rangeEndingAtSizeMax(scheduler);
+    emptyRangeIsDone(scheduler);
+    scheduler.stop();
+    return checkResult("bulk");
+}
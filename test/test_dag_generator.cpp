@@ -0,0 +1,152 @@
+#include "../include/dag_generator.hpp"
+#include "../include/graph_replay.hpp"
+#include "check.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include <unistd.h>
+
+// Records the order nodes ran in and how often each one ran
+struct OrderKernel {
+    std::atomic<uint64_t>* clock;
+    std::atomic<uint64_t>* order;
+    std::atomic<uint32_t>* runs;
+
+    void operator()(uint32_t node, uint16_t /*kernel*/, uint32_t /*cost_ns*/) const {
+        order[node].store(clock->fetch_add(1, std::memory_order_relaxed) + 1,
+                          std::memory_order_relaxed);
+        runs[node].fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+// Shape invariants every generator promises, checked on the in-memory graph
+static void checkShape(const GraphData& graph, uint64_t nodes, uint64_t edges) {
+    GraphView v = graph.view();
+    CHECK(v.node_count == nodes);
+    CHECK(v.edge_count == edges);
+    CHECK(graph.isAcyclic());
+    for (uint64_t n = 0; n < v.node_count; ++n)
+        for (uint64_t k = v.offsets[n]; k < v.offsets[n + 1]; ++k)
+            CHECK(v.targets[k] > n);
+}
+
+// Writes the graph out, loads it back and replays it: the loaded view
+// matches the original and every node runs once, after all of its parents.
+static void roundTrip(const GraphData& graph, Scheduler& scheduler, const std::string& path) {
+    writeGraphFile(path, graph.view());
+    GraphFile file(path);
+    const GraphView& v = file.view();
+    const GraphView g = graph.view();
+    CHECK(v.node_count == g.node_count && v.edge_count == g.edge_count);
+    if (v.node_count != g.node_count || v.edge_count != g.edge_count) return;
+    for (uint64_t n = 0; n <= v.node_count; ++n) CHECK(v.offsets[n] == g.offsets[n]);
+    for (uint64_t k = 0; k < v.edge_count; ++k) CHECK(v.targets[k] == g.targets[k]);
+    for (uint64_t n = 0; n < v.node_count; ++n) {
+        CHECK(v.in_degree[n] == g.in_degree[n]);
+        CHECK(v.cost_ns[n] == g.cost_ns[n]);
+    }
+
+    std::atomic<uint64_t> clock{0};
+    std::unique_ptr<std::atomic<uint64_t>[]> order(new std::atomic<uint64_t>[v.node_count]());
+    std::unique_ptr<std::atomic<uint32_t>[]> runs(new std::atomic<uint32_t>[v.node_count]());
+    GraphReplay<OrderKernel> replay(v, OrderKernel{&clock, order.get(), runs.get()});
+    replay.runAndWait(scheduler);
+
+    CHECK(clock.load() == v.node_count);
+    for (uint64_t n = 0; n < v.node_count; ++n) {
+        CHECK(runs[n].load() == 1);
+        for (uint64_t k = v.offsets[n]; k < v.offsets[n + 1]; ++k)
+            CHECK(order[n].load() < order[v.targets[k]].load());
+    }
+}
+
+static void shapes(Scheduler& scheduler, const std::string& path) {
+    CostModel cost{100, 50, 7};
+
+    GraphData independent = makeIndependentDag(500, cost);
+    checkShape(independent, 500, 0);
+    roundTrip(independent, scheduler, path);
+
+    GraphData chain = makeChainDag(300, cost);
+    checkShape(chain, 300, 299);
+    roundTrip(chain, scheduler, path);
+
+    GraphData fan = makeFanOutInDag(1000, cost);
+    checkShape(fan, 1002, 2000);
+    roundTrip(fan, scheduler, path);
+
+    GraphData diamonds = makeDiamondDag(100, cost);
+    checkShape(diamonds, 301, 400);
+    roundTrip(diamonds, scheduler, path);
+
+    // 2^7 leaves: 255 forks, 127 joins, 4 edges per internal fork
+    GraphData forkJoin = makeForkJoinDag(7, cost);
+    checkShape(forkJoin, 382, 508);
+    roundTrip(forkJoin, scheduler, path);
+
+    // Edge cells have two parents, inner cells three
+    GraphData stencil = makeStencilDag(32, 20, cost);
+    checkShape(stencil, 640, 19 * (32 * 3 - 2));
+    roundTrip(stencil, scheduler, path);
+
+    GraphData complete = makeErdosRenyiDag(40, 1.0, cost);
+    checkShape(complete, 40, 40 * 39 / 2);
+    GraphData random = makeErdosRenyiDag(400, 0.02, cost);
+    CHECK(random.isAcyclic());
+    roundTrip(random, scheduler, path);
+    CHECK(makeErdosRenyiDag(400, 0.0, cost).view().edge_count == 0);
+
+    for (uint32_t c : independent.cost_ns) CHECK(c >= 50 && c <= 150);
+}
+
+static void singleNodes() {
+    checkShape(makeForkJoinDag(0, {}), 1, 0);
+    checkShape(makeChainDag(1, {}), 1, 0);
+    checkShape(makeFanOutInDag(0, {}), 2, 0);
+}
+
+static bool rejects(GraphData (*make)()) {
+    try {
+        make();
+        return false;
+    } catch (const std::invalid_argument&) {
+        return true;
+    }
+}
+
+// Sizes whose ids or costs don't fit in 32 bits throw before allocating
+static void oversizedShapesAreRejected() {
+    CHECK(rejects([] { return makeForkJoinDag(31, {}); }));
+    CHECK(rejects([] { return makeForkJoinDag(64, {}); }));
+    CHECK(rejects([] { return makeStencilDag(1u << 16, (1u << 16) + 1, {}); }));
+    CHECK(rejects([] { return makeFanOutInDag(UINT32_MAX, {}); }));
+    CHECK(rejects([] { return makeDiamondDag(UINT32_MAX / 3, {}); }));
+    CHECK(rejects([] { return makeErdosRenyiDag(10, 1.5, {}); }));
+    CHECK(rejects([] { return makeErdosRenyiDag(10, -0.1, {}); }));
+    CHECK(rejects([] { return makeChainDag(10, {UINT32_MAX, 1, 0}); }));
+    CHECK(rejects([] { return makeIndependentDag(10, {UINT32_MAX - 5, 10, 0}); }));
+
+    // The largest cost model that fits is still accepted
+    GraphData edge = makeIndependentDag(10, {UINT32_MAX - 5, 5, 0});
+    for (uint32_t c : edge.cost_ns) CHECK(c >= UINT32_MAX - 10);
+}
+
+int main() {
+    const std::string path = "/tmp/dag_generator_test." + std::to_string(::getpid()) + ".bin";
+
+    Scheduler scheduler;
+    scheduler.start();
+    shapes(scheduler, path);
+    scheduler.stop();
+
+    singleNodes();
+    oversizedShapesAreRejected();
+
+    std::remove(path.c_str());
+    return checkResult("dag_generator");
+}
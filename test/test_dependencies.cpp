@@ -0,0 +1,133 @@
+#include "../include/scheduler.hpp"
+#include "check.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+// Children subscribe to a parent from several threads while the parent is
+// finishing. Registering a subscriber used to race with notifyFinished()
+// draining the list: subscriptions were lost or the list was corrupted.
+// Every child must run exactly once, and only after its parent's body.
+static void subscribeWhileParentFinishes(Scheduler& scheduler) {
+    constexpr uint64_t ROUNDS = 200;
+    constexpr uint64_t SUBSCRIBERS = 3;
+    constexpr uint64_t CHILDREN = 40;
+    constexpr uint64_t PER_ROUND = 1 + SUBSCRIBERS * CHILDREN;
+
+    std::atomic<uint64_t> ran = 0;
+    std::atomic<uint64_t> early = 0;
+    auto parentDone = std::make_unique<std::atomic<bool>[]>(ROUNDS);
+
+    for (uint64_t round = 0; round < ROUNDS; ++round) {
+        const uint64_t parent = 1 + round * PER_ROUND;
+        std::atomic<bool>& done = parentDone[round];
+        std::atomic<bool> go = false;
+
+        std::vector<std::thread> subscribers;
+        for (uint64_t t = 0; t < SUBSCRIBERS; ++t) {
+            subscribers.emplace_back([&, t] {
+                while (!go.load(std::memory_order_acquire)) {}
+                const uint64_t deps[] = {parent};
+                for (uint64_t c = 0; c < CHILDREN; ++c) {
+                    uint64_t child = parent + 1 + t * CHILDREN + c;
+                    scheduler.scheduleEvent(child, [&ran, &early, &done] {
+                        if (!done.load(std::memory_order_acquire))
+                            early.fetch_add(1, std::memory_order_relaxed);
+                        ran.fetch_add(1, std::memory_order_relaxed);
+                    }, deps);
+                }
+            });
+        }
+        scheduler.scheduleEvent(Event(parent, [&done, &go] {
+            go.store(true, std::memory_order_release);
+            done.store(true, std::memory_order_release);
+        }));
+        for (std::thread& t : subscribers) t.join();
+    }
+    scheduler.waitUntilFinished();
+
+    CHECK(ran == ROUNDS * SUBSCRIBERS * CHILDREN);
+    CHECK(early == 0);
+}
+
+// A rerun scheduled before its dependents is what they wait for, not the
+// run of the same id that already finished
+static void rerunBeforeDependents(Scheduler& scheduler) {
+    constexpr uint64_t A = 1'000'001, GATE = 1'000'002, CHILD = 1'000'003;
+    std::atomic<int> aRuns = 0, seenByChild = -1;
+    scheduler.scheduleEvent(A, [&] { ++aRuns; }, {});
+    scheduler.waitUntilFinished();
+    CHECK(scheduler.isFinished(A));
+
+    scheduler.scheduleEvent(A, [&] { ++aRuns; }, std::array<uint64_t, 1>{GATE});
+    CHECK(!scheduler.isFinished(A));
+    scheduler.scheduleEvent(CHILD, [&] { seenByChild = aRuns.load(); },
+                            std::array<uint64_t, 1>{A});
+    std::this_thread::sleep_for(20ms);
+    CHECK(seenByChild == -1);
+
+    scheduler.scheduleEvent(GATE, [] {}, {});
+    scheduler.waitUntilFinished();
+    CHECK(seenByChild == 2);
+    for (uint64_t id : {A, GATE, CHILD}) CHECK(scheduler.forget(id));
+}
+
+// A forgotten id counts as never scheduled: dependents wait for its next
+// run. Only finished ids can be forgotten.
+static void forgottenIdIsWaitedFor(Scheduler& scheduler) {
+    constexpr uint64_t A = 2'000'001, GATE = 2'000'002, CHILD = 2'000'003;
+    scheduler.scheduleEvent(A, [] {}, {});
+    scheduler.waitUntilFinished();
+    CHECK(scheduler.forget(A));
+    CHECK(!scheduler.isFinished(A));
+
+    std::atomic<bool> aRan = false, childEarly = false, childRan = false;
+    scheduler.scheduleEvent(CHILD, [&] {
+        childEarly = !aRan.load();
+        childRan = true;
+    }, std::array<uint64_t, 1>{A});
+    std::this_thread::sleep_for(20ms);
+    CHECK(!childRan);
+
+    scheduler.scheduleEvent(A, [&] { aRan = true; }, std::array<uint64_t, 1>{GATE});
+    CHECK(!scheduler.forget(A));
+    scheduler.scheduleEvent(GATE, [] {}, {});
+    scheduler.waitUntilFinished();
+    CHECK(childRan && !childEarly);
+    for (uint64_t id : {A, GATE, CHILD}) CHECK(scheduler.forget(id));
+}
+
+// A finished task lets go of what it captured right away, and until it is
+// forgotten still satisfies dependents scheduled late
+static void finishedTaskKeepsNoCaptures(Scheduler& scheduler) {
+    constexpr uint64_t A = 3'000'001, LATE = 3'000'002;
+    auto captured = std::make_shared<int>(7);
+    std::weak_ptr<int> watch = captured;
+    scheduler.scheduleEvent(A, [c = std::move(captured)] { (void)*c; }, {});
+    scheduler.waitUntilFinished();
+    CHECK(watch.expired());
+
+    std::atomic<bool> lateRan = false;
+    scheduler.scheduleEvent(LATE, [&] { lateRan = true; }, std::array<uint64_t, 1>{A});
+    scheduler.waitUntilFinished();
+    CHECK(lateRan);
+    CHECK(scheduler.forget(A) && scheduler.forget(LATE));
+}
+
+int main() {
+    Scheduler scheduler;
+    scheduler.start();
+    subscribeWhileParentFinishes(scheduler);
+    rerunBeforeDependents(scheduler);
+    forgottenIdIsWaitedFor(scheduler);
+    finishedTaskKeepsNoCaptures(scheduler);
+    scheduler.stop();
+    return checkResult("dependencies");
+}
@@ -0,0 +1,106 @@
+#include "../include/scheduler.hpp"
+#include "check.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+// Polls stats() until pred holds, giving up after a while so a stuck pool
+// fails the check instead of hanging the test
+template<typename Pred>
+static bool eventually(Scheduler& scheduler, Pred pred) {
+    auto deadline = std::chrono::steady_clock::now() + 10s;
+    while (!pred(scheduler.stats())) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(1ms);
+    }
+    return true;
+}
+
+static bool drained(const SchedulerStats& s) {
+    return s.tasksSubmitted == s.tasksCompleted;
+}
+
+static ElasticConfig oneToFour() {
+    ElasticConfig config;
+    config.minWorkers = 1;
+    config.maxWorkers = 4;
+    config.retireAfter = 20ms;
+    return config;
+}
+
+// A backlog far deeper than depthPerWorker grows the pool; once it has
+// drained, the extra workers retire back down to minWorkers. Affinity
+// events spread over every slot, parked, running or retired, all run.
+static void growsUnderLoadAndRetiresWhenIdle() {
+    constexpr std::size_t PLAIN = 4'000;
+    constexpr std::size_t PINNED = 1'000;
+    Scheduler scheduler;
+    scheduler.start(oneToFour());
+
+    std::atomic<std::size_t> ran = 0;
+    for (std::size_t i = 0; i < PLAIN; ++i) {
+        scheduler.scheduleEvent(Event(Scheduler::DETACHED_ID, [&ran] {
+            std::this_thread::sleep_for(20us);
+            ran.fetch_add(1, std::memory_order_relaxed);
+        }));
+        if (i % 4 == 0) {
+            scheduler.scheduleEvent(Event(Scheduler::DETACHED_ID, [&ran] {
+                ran.fetch_add(1, std::memory_order_relaxed);
+            }), static_cast<uint64_t>(i));
+        }
+    }
+    CHECK(eventually(scheduler, drained));
+    CHECK(ran == PLAIN + PINNED);
+
+    SchedulerStats busy = scheduler.stats();
+    CHECK(busy.peakWorkers > 1);
+    CHECK(busy.peakWorkers <= 4);
+    CHECK(busy.scaleUps >= busy.peakWorkers - 1);
+
+    CHECK(eventually(scheduler, [](const SchedulerStats& s) { return s.activeWorkers == 1; }));
+    SchedulerStats idle = scheduler.stats();
+    CHECK(idle.scaleDowns == idle.scaleUps);
+    CHECK(idle.tasksCompleted == PLAIN + PINNED);
+
+    // Retired slots no longer take affinity events into their inbox
+    for (uint64_t i = 0; i < PINNED; ++i) {
+        scheduler.scheduleEvent(Event(Scheduler::DETACHED_ID, [&ran] {
+            ran.fetch_add(1, std::memory_order_relaxed);
+        }), i);
+    }
+    CHECK(eventually(scheduler, drained));
+    CHECK(ran == PLAIN + 2 * PINNED);
+    scheduler.stop();
+}
+
+// The scaling counters, peakWorkers included, describe the current run
+static void restartResetsScalingStats() {
+    Scheduler scheduler;
+    scheduler.start(oneToFour());
+    for (std::size_t i = 0; i < 4'000; ++i) {
+        scheduler.scheduleEvent(Event(Scheduler::DETACHED_ID, [] {
+            std::this_thread::sleep_for(20us);
+        }));
+    }
+    CHECK(eventually(scheduler, drained));
+    CHECK(scheduler.stats().peakWorkers > 1);
+    scheduler.stop();
+
+    scheduler.start(oneToFour());
+    SchedulerStats fresh = scheduler.stats();
+    CHECK(fresh.peakWorkers == 1);
+    CHECK(fresh.scaleUps == 0);
+    CHECK(fresh.scaleDowns == 0);
+    scheduler.stop();
+}
+
+int main() {
+    growsUnderLoadAndRetiresWhenIdle();
+    restartResetsScalingStats();
+    return checkResult("elastic");
+}
@@ -0,0 +1,86 @@
+#include "../include/scheduler.hpp"
+#include "check.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Sums [lo, hi) by forking both halves and waiting for them from inside
+// the event. Every level blocks in waitFor(), so with far more levels than
+// workers the pool only gets through it if waiting workers run the
+// children themselves. A deadlock shows up as the test timing out.
+static void forkSum(Scheduler& scheduler, uint64_t lo, uint64_t hi, uint64_t* out) {
+    if (hi - lo == 1) {
+        *out = lo;
+        return;
+    }
+    uint64_t mid = lo + (hi - lo) / 2;
+    uint64_t left = 0, right = 0;
+    std::atomic<int> pending = 2;
+    auto half = [&scheduler, &pending](uint64_t a, uint64_t b, uint64_t* result) {
+        return Event(Scheduler::DETACHED_ID, [&scheduler, &pending, a, b, result] {
+            forkSum(scheduler, a, b, result);
+            pending.fetch_sub(1, std::memory_order_release);
+        });
+    };
+    scheduler.scheduleEvent(half(lo, mid, &left));
+    scheduler.scheduleEvent(half(mid, hi, &right));
+    scheduler.waitFor([&pending] { return pending.load(std::memory_order_acquire) == 0; });
+    *out = left + right;
+}
+
+// Runs the root as an event and waits for it from outside the pool
+static uint64_t runSum(Scheduler& scheduler, uint64_t n) {
+    uint64_t total = 0;
+    std::atomic<bool> done = false;
+    scheduler.scheduleEvent(Event(Scheduler::DETACHED_ID, [&scheduler, &total, &done, n] {
+        forkSum(scheduler, 0, n, &total);
+        done.store(true, std::memory_order_release);
+    }));
+    scheduler.waitFor([&done] { return done.load(std::memory_order_acquire); });
+    return total;
+}
+
+// One level per event: each waits on the next, a chain far deeper than
+// the pool is wide
+static void chain(Scheduler& scheduler, unsigned depth, std::atomic<unsigned>* reached) {
+    reached->fetch_add(1, std::memory_order_relaxed);
+    if (depth == 0) return;
+    std::atomic<bool> done = false;
+    scheduler.scheduleEvent(Event(Scheduler::DETACHED_ID, [&scheduler, &done, depth, reached] {
+        chain(scheduler, depth - 1, reached);
+        done.store(true, std::memory_order_release);
+    }));
+    scheduler.waitFor([&done] { return done.load(std::memory_order_acquire); });
+}
+
+static void nestedForkJoin(std::size_t workers) {
+    ElasticConfig fixed;
+    fixed.minWorkers = fixed.maxWorkers = workers;
+    Scheduler scheduler;
+    scheduler.start(fixed);
+
+    // 14 levels of binary forks over 16384 leaves
+    constexpr uint64_t N = uint64_t{1} << 14;
+    CHECK(runSum(scheduler, N) == N * (N - 1) / 2);
+
+    constexpr unsigned DEPTH = 300;
+    std::atomic<unsigned> reached = 0;
+    std::atomic<bool> done = false;
+    scheduler.scheduleEvent(Event(Scheduler::DETACHED_ID, [&scheduler, &reached, &done] {
+        chain(scheduler, DEPTH, &reached);
+        done.store(true, std::memory_order_release);
+    }));
+    scheduler.waitFor([&done] { return done.load(std::memory_order_acquire); });
+    CHECK(reached == DEPTH + 1);
+
+    scheduler.waitUntilFinished();
+    scheduler.stop();
+}
+
+int main() {
+    nestedForkJoin(1);
+    nestedForkJoin(2);
+    nestedForkJoin(4);
+    return checkResult("fork_join");
+}
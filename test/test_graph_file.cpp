@@ -0,0 +1,124 @@
+#include "../include/graph_file.hpp"
+#include "check.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+// 0 -> 1 -> 3, 0 -> 2 -> 3
+static GraphData diamond() {
+    std::vector<std::pair<uint32_t, uint32_t>> edges = {{0, 1}, {0, 2}, {1, 3}, {2, 3}};
+    return GraphData::fromEdges(4, edges, {10, 20, 30, 40}, {0, 1, 0, 1});
+}
+
+static std::vector<char> readAll(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+}
+
+static void writeAll(const std::string& path, const std::vector<char>& bytes) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+template<typename T>
+static void poke(std::vector<char>& bytes, uint64_t at, T value) {
+    std::memcpy(bytes.data() + at, &value, sizeof(value));
+}
+
+static bool loads(const std::string& path) {
+    try {
+        GraphFile file(path);
+        return true;
+    } catch (const std::runtime_error&) {
+        return false;
+    }
+}
+
+static void roundTrip(const std::string& path) {
+    GraphData graph = diamond();
+    writeGraphFile(path, graph.view());
+    GraphFile file(path);
+    const GraphView& v = file.view();
+    CHECK(v.node_count == 4);
+    CHECK(v.edge_count == 4);
+    CHECK(v.offsets[4] == 4);
+    CHECK(v.in_degree[3] == 2);
+    CHECK(v.cost_ns[2] == 30);
+    CHECK(v.kernel[3] == 1);
+}
+
+// Each corruption starts from the valid file and must be refused on load
+static void corruptFilesAreRejected(const std::string& good, const std::string& bad) {
+    const std::vector<char> original = readAll(good);
+    GraphFileHeader h;
+    std::memcpy(&h, original.data(), sizeof(h));
+
+    const std::vector<std::pair<const char*, std::function<void(std::vector<char>&)>>> cases = {
+        {"target out of range", [&](std::vector<char>& b) {
+            poke<uint32_t>(b, h.targets_offset, 0x7fffffff);
+        }},
+        {"offsets decrease", [&](std::vector<char>& b) {
+            poke<uint64_t>(b, h.offsets_offset + 2 * sizeof(uint64_t), 1);
+        }},
+        {"offsets end short of edge_count", [&](std::vector<char>& b) {
+            poke<uint64_t>(b, h.offsets_offset + 4 * sizeof(uint64_t), 3);
+        }},
+        {"in_degree too low", [&](std::vector<char>& b) {
+            poke<uint32_t>(b, h.in_degree_offset + 3 * sizeof(uint32_t), 1);
+        }},
+        {"in_degree too high", [&](std::vector<char>& b) {
+            poke<uint32_t>(b, h.in_degree_offset + 1 * sizeof(uint32_t), 2);
+        }},
+        {"cycle", [&](std::vector<char>& b) {
+            // 1 -> 3 becomes 1 -> 0; in_degree follows so only the cycle is wrong
+            poke<uint32_t>(b, h.targets_offset + 2 * sizeof(uint32_t), 0);
+            poke<uint32_t>(b, h.in_degree_offset + 0 * sizeof(uint32_t), 1);
+            poke<uint32_t>(b, h.in_degree_offset + 3 * sizeof(uint32_t), 1);
+        }},
+        {"edge_count overflows the layout", [&](std::vector<char>& b) {
+            poke<uint64_t>(b, offsetof(GraphFileHeader, edge_count), UINT64_MAX / 2);
+        }},
+        {"node_count beyond 32 bits", [&](std::vector<char>& b) {
+            poke<uint64_t>(b, offsetof(GraphFileHeader, node_count), uint64_t{1} << 40);
+        }},
+        {"truncated", [&](std::vector<char>& b) {
+            b.resize(b.size() - 1);
+        }},
+        {"bad magic", [&](std::vector<char>& b) {
+            b[0] = 'X';
+        }},
+    };
+
+    for (const auto& [name, corrupt] : cases) {
+        std::vector<char> bytes = original;
+        corrupt(bytes);
+        writeAll(bad, bytes);
+        bool accepted = loads(bad);
+        if (accepted) std::cerr << "accepted corrupt file: " << name << "\n";
+        CHECK(!accepted);
+    }
+}
+
+int main() {
+    const std::string base = "/tmp/graph_file_test." + std::to_string(::getpid());
+    const std::string good = base + ".good.bin";
+    const std::string bad = base + ".bad.bin";
+
+    roundTrip(good);
+    corruptFilesAreRejected(good, bad);
+
+    std::remove(good.c_str());
+    std::remove(bad.c_str());
+    return checkResult("graph_file");
+}
@@ -0,0 +1,270 @@
+#include "../include/reactor.hpp"
+#include "../external/Task.hpp"
+#include "check.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace std::chrono_literals;
+
+// Result a callback hasn't written yet
+constexpr int64_t PENDING = INT64_MIN;
+
+// Waits for done() on the scheduler, giving up after a while so a lost
+// completion fails the check instead of hanging the test
+template<typename Pred>
+static bool waitUntil(Scheduler& scheduler, Pred&& done) {
+    auto deadline = std::chrono::steady_clock::now() + 5s;
+    bool timedOut = false;
+    scheduler.waitFor([&] {
+        if (done()) return true;
+        timedOut = std::chrono::steady_clock::now() > deadline;
+        return timedOut;
+    });
+    return !timedOut;
+}
+
+static const char* name(Reactor::Backend backend) {
+    return backend == Reactor::Backend::IoUring ? "io_uring" : "epoll";
+}
+
+// Destroying the reactor completes everything still outstanding with
+// -ECANCELED before it returns, including ops queued behind others
+static void shutdownCancelsOutstanding(Scheduler& scheduler, Reactor::Backend backend) {
+    int fds[2];
+    CHECK(::pipe(fds) == 0);
+    char buf[2] = {};
+    std::atomic<int64_t> readResult = PENDING, secondRead = PENDING, timeoutResult = PENDING;
+    {
+        Reactor reactor(scheduler, backend);
+        reactor.read(fds[0], &buf[0], 1, -1, [&](int64_t n) { readResult = n; });
+        reactor.read(fds[0], &buf[1], 1, -1, [&](int64_t n) { secondRead = n; });
+        reactor.timeout(10s, [&](int64_t n) { timeoutResult = n; });
+        std::this_thread::sleep_for(5ms);
+        CHECK(reactor.outstanding() == 3);
+    }
+    CHECK(readResult == -ECANCELED);
+    CHECK(secondRead == -ECANCELED);
+    CHECK(timeoutResult == -ECANCELED);
+    ::close(fds[0]);
+    ::close(fds[1]);
+}
+
+// A callback that resubmits on cancellation still gets completed
+static void resubmitDuringShutdown(Scheduler& scheduler, Reactor::Backend backend) {
+    std::atomic<int> cancelled = 0;
+    {
+        Reactor reactor(scheduler, backend);
+        reactor.timeout(10s, [&](int64_t n) {
+            if (n == -ECANCELED) ++cancelled;
+            reactor.timeout(10s, [&](int64_t m) {
+                if (m == -ECANCELED) ++cancelled;
+            });
+        });
+        std::this_thread::sleep_for(5ms);
+    }
+    CHECK(cancelled == 2);
+}
+
+// A request that can't be registered fails on its own; what is already
+// waiting on other fds is unaffected
+static void failedRequestIsIsolated(Scheduler& scheduler, Reactor::Backend backend) {
+    Reactor reactor(scheduler, backend);
+    int fds[2];
+    CHECK(::pipe(fds) == 0);
+    // Closed after the reactor opened its own fds so the number isn't reused
+    int closed = ::dup(fds[0]);
+    ::close(closed);
+
+    char in = 0, out = 'x';
+    std::atomic<int64_t> good = PENDING, bad = PENDING;
+    reactor.read(fds[0], &in, 1, -1, [&](int64_t n) { good = n; });
+    reactor.read(closed, &in, 1, -1, [&](int64_t n) { bad = n; });
+    CHECK(waitUntil(scheduler, [&] { return bad != PENDING; }));
+    CHECK(bad == -EBADF);
+    CHECK(good == PENDING);
+
+    CHECK(::write(fds[1], &out, 1) == 1);
+    CHECK(waitUntil(scheduler, [&] { return good != PENDING; }));
+    CHECK(good == 1 && in == 'x');
+    CHECK(waitUntil(scheduler, [&] { return reactor.outstanding() == 0; }));
+    ::close(fds[0]);
+    ::close(fds[1]);
+}
+
+// A read submitted on an empty pipe waits for the writer instead of
+// returning 0 or -EAGAIN
+static void pipeReadBeforeWrite(Scheduler& scheduler, Reactor& reactor) {
+    int fds[2];
+    CHECK(::pipe(fds) == 0);
+    char in[4] = {};
+    std::atomic<int64_t> result = PENDING;
+    reactor.read(fds[0], in, sizeof(in), -1, [&](int64_t n) { result = n; });
+    std::this_thread::sleep_for(20ms);
+    CHECK(result == PENDING);
+
+    CHECK(::write(fds[1], "abc", 3) == 3);
+    CHECK(waitUntil(scheduler, [&] { return result != PENDING; }));
+    CHECK(result == 3 && std::memcmp(in, "abc", 3) == 0);
+    ::close(fds[0]);
+    ::close(fds[1]);
+}
+
+// Explicit offsets go to pwrite/pread, regular files included (epoll can't
+// poll those, so they run on the reactor thread)
+static void fileOffsets(Scheduler& scheduler, Reactor& reactor) {
+    char path[] = "/tmp/reactor_test.XXXXXX";
+    int fd = ::mkstemp(path);
+    CHECK(fd >= 0);
+    ::unlink(path);
+
+    std::atomic<int64_t> tail = PENDING, head = PENDING;
+    reactor.write(fd, "world", 5, 6, [&](int64_t n) { tail = n; });
+    reactor.write(fd, "hello ", 6, 0, [&](int64_t n) { head = n; });
+    CHECK(waitUntil(scheduler, [&] { return tail != PENDING && head != PENDING; }));
+    CHECK(tail == 5 && head == 6);
+
+    char in[16] = {};
+    std::atomic<int64_t> got = PENDING, past = PENDING;
+    reactor.read(fd, in, 5, 6, [&](int64_t n) { got = n; });
+    reactor.read(fd, in + 8, 4, 100, [&](int64_t n) { past = n; });
+    CHECK(waitUntil(scheduler, [&] { return got != PENDING && past != PENDING; }));
+    CHECK(got == 5 && std::memcmp(in, "world", 5) == 0);
+    CHECK(past == 0);
+    ::close(fd);
+}
+
+// Accept a loopback connection, then read what the client sent through
+// the accepted fd
+static void acceptThenRead(Scheduler& scheduler, Reactor& reactor) {
+    int listener = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    CHECK(listener >= 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof(addr);
+    CHECK(::bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+    CHECK(::listen(listener, 4) == 0);
+    CHECK(::getsockname(listener, reinterpret_cast<sockaddr*>(&addr), &len) == 0);
+
+    std::atomic<int64_t> accepted = PENDING;
+    reactor.accept(listener, [&](int64_t fd) { accepted = fd; });
+    std::this_thread::sleep_for(20ms);
+    CHECK(accepted == PENDING);
+
+    int client = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    CHECK(::connect(client, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+    CHECK(waitUntil(scheduler, [&] { return accepted != PENDING; }));
+    CHECK(accepted >= 0);
+
+    char in = 0;
+    std::atomic<int64_t> got = PENDING;
+    if (accepted >= 0)
+        reactor.read(static_cast<int>(accepted), &in, 1, -1, [&](int64_t n) { got = n; });
+    CHECK(::write(client, "y", 1) == 1);
+    CHECK(waitUntil(scheduler, [&] { return got != PENDING; }));
+    CHECK(got == 1 && in == 'y');
+
+    if (accepted >= 0) ::close(static_cast<int>(accepted));
+    ::close(client);
+    ::close(listener);
+}
+
+static Task readThenSleep(Reactor& reactor, int fd, char* buf,
+                          std::atomic<int64_t>& got, std::atomic<int64_t>& slept) {
+    got = co_await reactor.read(fd, buf, 1);
+    slept = co_await reactor.timeout(5ms);
+}
+
+// A Task suspends on co_await and is resumed on a worker by the completion
+static void coroutineAwaits(Scheduler& scheduler, Reactor& reactor) {
+    int fds[2];
+    CHECK(::pipe(fds) == 0);
+    char in = 0;
+    std::atomic<int64_t> got = PENDING, slept = PENDING;
+    {
+        Task task = readThenSleep(reactor, fds[0], &in, got, slept);
+        task.start();
+        CHECK(got == PENDING);
+        CHECK(::write(fds[1], "z", 1) == 1);
+        CHECK(waitUntil(scheduler, [&] { return slept != PENDING; }));
+        // The frame is still on a worker until its completion event returns
+        CHECK(waitUntil(scheduler, [&] { return reactor.outstanding() == 0; }));
+    }
+    CHECK(got == 1 && in == 'z');
+    CHECK(slept == 0);
+    ::close(fds[0]);
+    ::close(fds[1]);
+}
+
+// A timeout fires no earlier than asked, and many at once all fire
+static void timeouts(Scheduler& scheduler, Reactor& reactor) {
+    auto start = std::chrono::steady_clock::now();
+    std::atomic<int64_t> result = PENDING;
+    std::atomic<int64_t> firedAfter = 0;
+    reactor.timeout(20ms, [&](int64_t n) {
+        firedAfter = (std::chrono::steady_clock::now() - start).count();
+        result = n;
+    });
+    CHECK(waitUntil(scheduler, [&] { return result != PENDING; }));
+    CHECK(result == 0);
+    CHECK(firedAfter >= std::chrono::nanoseconds(20ms).count());
+
+    constexpr int COUNT = 1000;
+    std::atomic<int> fired = 0, failed = 0;
+    for (int i = 0; i < COUNT; ++i) {
+        reactor.timeout(std::chrono::microseconds(i * 10), [&](int64_t n) {
+            if (n == 0) ++fired;
+            else ++failed;
+        });
+    }
+    CHECK(waitUntil(scheduler, [&] { return fired + failed == COUNT; }));
+    CHECK(fired == COUNT);
+}
+
+static void runAll(Scheduler& scheduler, Reactor::Backend backend) {
+    {
+        Reactor probe(scheduler, backend);
+        if (probe.backend() != backend) {
+            std::cout << "[Test] reactor: " << name(backend) << " unavailable, skipped\n";
+            return;
+        }
+    }
+    int before = checkFailures();
+    {
+        Reactor reactor(scheduler, backend);
+        pipeReadBeforeWrite(scheduler, reactor);
+        fileOffsets(scheduler, reactor);
+        acceptThenRead(scheduler, reactor);
+        coroutineAwaits(scheduler, reactor);
+        timeouts(scheduler, reactor);
+    }
+    shutdownCancelsOutstanding(scheduler, backend);
+    resubmitDuringShutdown(scheduler, backend);
+    failedRequestIsIsolated(scheduler, backend);
+    if (checkFailures() != before)
+        std::cerr << "reactor checks above failed on " << name(backend) << "\n";
+}
+
+int main() {
+    Scheduler scheduler;
+    scheduler.start();
+    runAll(scheduler, Reactor::Backend::IoUring);
+    runAll(scheduler, Reactor::Backend::Epoll);
+    scheduler.stop();
+    return checkResult("reactor");
+}
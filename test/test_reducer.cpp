@@ -0,0 +1,59 @@
+#include "../include/reducer.hpp"
+#include "check.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Events spread over every worker add into their own slots; combine()
+// sees each contribution exactly once
+static void sumAcrossWorkers(Scheduler& scheduler) {
+    constexpr uint64_t N = 100'000;
+    Reducer<uint64_t> sum(scheduler);
+    std::atomic<uint64_t> done = 0;
+    for (uint64_t i = 1; i <= N; ++i) {
+        scheduler.scheduleEvent(Event(Scheduler::DETACHED_ID, [i, &sum, &done] {
+            sum.add(i);
+            done.fetch_add(1, std::memory_order_release);
+        }));
+    }
+    // The submitting thread has a slot of its own
+    sum.add(7);
+    scheduler.waitFor([&] { return done.load(std::memory_order_acquire) == N; });
+    CHECK(sum.combine() == N * (N + 1) / 2 + 7);
+
+    sum.reset();
+    CHECK(sum.combine() == 0);
+}
+
+struct Max {
+    uint64_t operator()(uint64_t a, uint64_t b) const { return std::max(a, b); }
+};
+
+// Nested events, a custom operator and an identity other than T{}
+static void maxFromNestedEvents(Scheduler& scheduler) {
+    constexpr uint64_t N = 1'000;
+    Reducer<uint64_t, Max> top(scheduler, 5, Max{});
+    CHECK(top.combine() == 5);
+    std::atomic<uint64_t> done = 0;
+    scheduler.scheduleEvent(Event(Scheduler::DETACHED_ID, [&scheduler, &top, &done] {
+        for (uint64_t i = 0; i < N; ++i) {
+            scheduler.scheduleEvent(Event(Scheduler::DETACHED_ID, [i, &top, &done] {
+                top.add(i * 3 % 2'017);
+                done.fetch_add(1, std::memory_order_release);
+            }));
+        }
+    }));
+    scheduler.waitFor([&] { return done.load(std::memory_order_acquire) == N; });
+    CHECK(top.combine() == 2'016);
+}
+
+int main() {
+    Scheduler scheduler;
+    scheduler.start();
+    sumAcrossWorkers(scheduler);
+    maxFromNestedEvents(scheduler);
+    scheduler.stop();
+    return checkResult("reducer");
+}
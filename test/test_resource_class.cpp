@@ -0,0 +1,101 @@
+#include "../include/scheduler.hpp"
+#include "check.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+
+// Counts how many events of one class run at once
+struct Gauge {
+    std::atomic<std::size_t> inFlight = 0;
+    std::atomic<std::size_t> peak = 0;
+    std::atomic<std::size_t> ran = 0;
+
+    void enter() {
+        std::size_t now = inFlight.fetch_add(1) + 1;
+        std::size_t seen = peak.load();
+        while (now > seen && !peak.compare_exchange_weak(seen, now)) {}
+    }
+    void leave() {
+        ran.fetch_add(1);
+        inFlight.fetch_sub(1);
+    }
+};
+
+// Two classes and unlimited events mixed on a pool with more workers than
+// tokens: neither class ever runs more events than it has tokens, and
+// every parked event runs in the end
+static void limitsHoldAndParkedEventsRun() {
+    constexpr std::size_t EVENTS = 200;
+    constexpr std::size_t DISK_TOKENS = 2;
+    ElasticConfig fixed;
+    fixed.minWorkers = fixed.maxWorkers = 4;
+    Scheduler pool;
+    ResourceClass disk = pool.addResourceClass("disk", DISK_TOKENS);
+    ResourceClass gpu = pool.addResourceClass("gpu", 1);
+    CHECK(pool.findResourceClass("gpu").index == gpu.index);
+    pool.start(fixed);
+
+    Gauge diskGauge, gpuGauge;
+    std::atomic<std::size_t> free = 0;
+    for (std::size_t i = 0; i < EVENTS; ++i) {
+        pool.scheduleEvent(Event(Scheduler::DETACHED_ID, [&diskGauge] {
+            diskGauge.enter();
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+            diskGauge.leave();
+        }), disk);
+        pool.scheduleEvent(Event(Scheduler::DETACHED_ID, [&gpuGauge] {
+            gpuGauge.enter();
+            std::this_thread::sleep_for(std::chrono::microseconds(20));
+            gpuGauge.leave();
+        }), gpu);
+        pool.scheduleEvent(Event(Scheduler::DETACHED_ID, [&free] { ++free; }));
+    }
+    pool.markDone();
+    pool.waitUntilFinished();
+    pool.stop();
+
+    CHECK(diskGauge.peak <= DISK_TOKENS);
+    CHECK(gpuGauge.peak == 1);
+    CHECK(diskGauge.ran == EVENTS);
+    CHECK(gpuGauge.ran == EVENTS);
+    CHECK(free == EVENTS);
+}
+
+// Events of a class spawned by events holding that class's only token:
+// each child parks until a token is free, none is lost or run early
+static void nestedSubmissionsOfTheSameClass() {
+    constexpr std::size_t PARENTS = 50, CHILDREN = 4;
+    ElasticConfig fixed;
+    fixed.minWorkers = fixed.maxWorkers = 3;
+    Scheduler pool;
+    ResourceClass disk = pool.addResourceClass("disk", 1);
+    pool.start(fixed);
+
+    Gauge gauge;
+    for (std::size_t i = 0; i < PARENTS; ++i) {
+        pool.scheduleEvent(Event(Scheduler::DETACHED_ID, [&pool, &gauge, disk] {
+            gauge.enter();
+            for (std::size_t c = 0; c < CHILDREN; ++c) {
+                pool.scheduleEvent(Event(Scheduler::DETACHED_ID, [&gauge] {
+                    gauge.enter();
+                    gauge.leave();
+                }), disk);
+            }
+            gauge.leave();
+        }), disk);
+    }
+    pool.markDone();
+    pool.waitUntilFinished();
+    pool.stop();
+
+    CHECK(gauge.peak == 1);
+    CHECK(gauge.ran == PARENTS * (1 + CHILDREN));
+}
+
+int main() {
+    limitsHoldAndParkedEventsRun();
+    nestedSubmissionsOfTheSameClass();
+    return checkResult("resource_class");
+}
@@ -0,0 +1,91 @@
+#include "../include/scheduler.hpp"
+#include "check.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+// Move-only value that counts live instances: a copy wouldn't compile,
+// and a leak or an early free shows in the count
+struct Tracked {
+    static inline std::atomic<int> live = 0;
+
+    explicit Tracked(uint64_t v) : value(v) { ++live; }
+    Tracked(Tracked&& other) noexcept : value(other.value) { ++live; }
+    Tracked(const Tracked&) = delete;
+    Tracked& operator=(const Tracked&) = delete;
+    ~Tracked() { --live; }
+
+    uint64_t value;
+};
+
+// Values reach dependents by const reference through a diamond, and the
+// last result is readable from the caller's handle
+static void valuesFlowToDependents(Scheduler& scheduler) {
+    constexpr uint64_t BASE = 100;
+    TaskResult<Tracked> a = scheduler.scheduleEvent(BASE, [] { return Tracked(6); });
+    TaskResult<uint64_t> b = scheduler.scheduleEvent(BASE + 1,
+        [](const Tracked& x) { return x.value * 7; }, a);
+    TaskResult<std::string> c = scheduler.scheduleEvent(BASE + 2,
+        [](const Tracked& x) { return std::string(x.value, 'c'); }, a);
+    TaskResult<std::string> d = scheduler.scheduleEvent(BASE + 3,
+        [](const uint64_t& n, const std::string& s) { return std::to_string(n) + s; }, b, c);
+    CHECK(d.id() == BASE + 3);
+
+    scheduler.waitUntilFinished();
+    CHECK(a.ready() && b.ready() && c.ready() && d.ready());
+    CHECK(a.get().value == 6);
+    CHECK(b.get() == 42);
+    CHECK(d.get() == "42cccccc");
+    for (uint64_t id = BASE; id < BASE + 4; ++id) scheduler.forget(id);
+}
+
+// A value lives while a consumer still has to run or anyone holds a handle
+// to it, and is freed once both are gone, whichever goes last
+static void valueReleasedAfterLastUse(Scheduler& scheduler) {
+    constexpr uint64_t BASE = 200;
+    CHECK(Tracked::live == 0);
+
+    // Consumers finish first, the caller's handle keeps the value
+    TaskResult<Tracked> kept = scheduler.scheduleEvent(BASE, [] { return Tracked(1); });
+    TaskResult<uint64_t> sum = scheduler.scheduleEvent(BASE + 1,
+        [](const Tracked& x) { return x.value + 1; }, kept);
+    TaskResult<uint64_t> twice = scheduler.scheduleEvent(BASE + 2,
+        [](const Tracked& x) { return x.value * 2; }, kept);
+    scheduler.waitUntilFinished();
+    CHECK(sum.get() == 2 && twice.get() == 2);
+    CHECK(Tracked::live == 1);
+    CHECK(kept.get().value == 1);
+
+    TaskResult<Tracked> copy = kept;
+    kept = TaskResult<Tracked>();
+    CHECK(Tracked::live == 1);
+    copy = TaskResult<Tracked>();
+    CHECK(Tracked::live == 0);
+
+    // The caller drops its handle first, the last consumer frees the value
+    std::atomic<bool> go = false;
+    TaskResult<Tracked> gated = scheduler.scheduleEvent(BASE + 3, [&go] {
+        while (!go.load(std::memory_order_acquire)) {}
+        return Tracked(2);
+    });
+    TaskResult<uint64_t> reader = scheduler.scheduleEvent(BASE + 4,
+        [](const Tracked& x) { return x.value; }, gated);
+    gated = TaskResult<Tracked>();
+    go.store(true, std::memory_order_release);
+    scheduler.waitUntilFinished();
+    CHECK(reader.get() == 2);
+    CHECK(Tracked::live == 0);
+    for (uint64_t id = BASE; id < BASE + 5; ++id) scheduler.forget(id);
+}
+
+int main() {
+    Scheduler scheduler;
+    scheduler.start();
+    valuesFlowToDependents(scheduler);
+    valueReleasedAfterLastUse(scheduler);
+    scheduler.stop();
+    CHECK(Tracked::live == 0);
+    return checkResult("task_result");
+}
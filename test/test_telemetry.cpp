@@ -0,0 +1,110 @@
+#include "../include/scheduler.hpp"
+#include "check.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace std::chrono_literals;
+using TelemetryScheduler = BasicScheduler<TelemetryHooks>;
+
+template<typename Sched>
+static bool drains(Sched& scheduler) {
+    auto deadline = std::chrono::steady_clock::now() + 5s;
+    while (true) {
+        SchedulerStats s = scheduler.stats();
+        if (s.tasksSubmitted == s.tasksCompleted) return true;
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(1ms);
+    }
+}
+
+template<typename Sched>
+static void submit(Sched& scheduler, std::atomic<std::size_t>& ran, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        scheduler.scheduleEvent(Event(Sched::DETACHED_ID, [&ran] {
+            ran.fetch_add(1, std::memory_order_relaxed);
+        }));
+    }
+}
+
+// The submitted/completed totals carry across stop() and start(): stopping
+// and restarting an idle pool changes nothing, and new work adds onto them
+static void countsSurviveRestart() {
+    constexpr std::size_t N = 2'000;
+    ElasticConfig two;
+    two.minWorkers = two.maxWorkers = 2;
+    Scheduler scheduler;
+    scheduler.start(two);
+
+    std::atomic<std::size_t> ran = 0;
+    submit(scheduler, ran, N);
+    CHECK(drains(scheduler));
+    scheduler.stop();
+
+    SchedulerStats stopped = scheduler.stats();
+    CHECK(stopped.tasksSubmitted == N);
+    CHECK(stopped.tasksCompleted == N);
+    CHECK(stopped.queueDepth == 0);
+
+    scheduler.start(two);
+    SchedulerStats restarted = scheduler.stats();
+    CHECK(restarted.tasksSubmitted == N);
+    CHECK(restarted.tasksCompleted == N);
+
+    submit(scheduler, ran, N);
+    CHECK(drains(scheduler));
+    SchedulerStats again = scheduler.stats();
+    CHECK(again.tasksSubmitted == 2 * N);
+    CHECK(again.tasksCompleted == 2 * N);
+    CHECK(ran == 2 * N);
+
+    // The idle pool has nothing outstanding, so the wait returns at once
+    scheduler.markDone();
+    scheduler.waitUntilFinished();
+    scheduler.stop();
+}
+
+// Every callback fires: each event is counted once enqueued and once run,
+// and the pool size changes are recorded instead of printed
+static void telemetryHooksFire() {
+    constexpr std::size_t N = 1'000;
+    std::ostringstream captured;
+    std::streambuf* previous = std::cout.rdbuf(captured.rdbuf());
+
+    ElasticConfig config;
+    config.minWorkers = config.maxWorkers = 3;
+    TelemetryScheduler scheduler;
+    scheduler.start(config);
+    const TelemetryHooks& hooks = scheduler.hooks();
+    CHECK(hooks.activeWorkers() == 3);
+
+    std::atomic<std::size_t> ran = 0;
+    submit(scheduler, ran, N);
+    CHECK(drains(scheduler));
+    CHECK(ran == N);
+    CHECK(hooks.enqueued() == N);
+    CHECK(hooks.executed() == N);
+
+    scheduler.stop();
+    CHECK(hooks.activeWorkers() == 0);
+    CHECK(hooks.peakWorkers() == 3);
+    CHECK(hooks.poolChanges() == 3);   // sized, started, stopped
+    std::cout.rdbuf(previous);
+    CHECK(captured.str().empty());
+
+    std::ostringstream report;
+    hooks.report(report);
+    CHECK(report.str().find(std::to_string(N) + " events enqueued") != std::string::npos);
+}
+
+int main() {
+    countsSurviveRestart();
+    telemetryHooksFire();
+    return checkResult("telemetry");
+}